@@ -0,0 +1,256 @@
+#include "AssetManager.h"
+
+#include <algorithm>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../core/Paths.h"
+#include "../vendor/stb/stb_image.h"
+
+// box filter down to fit maxSide, averaging in premultiplied alpha so transparent edges do not darken
+static void downscale(std::vector<uint8_t> &pixels, int &width, int &height, const int &maxSide) {
+    const int largest = std::max(width, height);
+    if (maxSide <= 0 || largest <= maxSide) {
+        return;
+    }
+
+    const int newWidth = std::max(1, width * maxSide / largest);
+    const int newHeight = std::max(1, height * maxSide / largest);
+    std::vector<uint8_t> scaled(static_cast<size_t>(newWidth) * newHeight * 4);
+
+    for (int y = 0; y < newHeight; y++) {
+        const int srcY0 = y * height / newHeight;
+        const int srcY1 = std::max(srcY0 + 1, (y + 1) * height / newHeight);
+
+        for (int x = 0; x < newWidth; x++) {
+            const int srcX0 = x * width / newWidth;
+            const int srcX1 = std::max(srcX0 + 1, (x + 1) * width / newWidth);
+
+            double r = 0, g = 0, b = 0, a = 0;
+            for (int sy = srcY0; sy < srcY1; sy++) {
+                const uint8_t *row = pixels.data() + (static_cast<size_t>(sy) * width + srcX0) * 4;
+                for (int sx = srcX0; sx < srcX1; sx++, row += 4) {
+                    const double alpha = row[3];
+                    r += row[0] * alpha;
+                    g += row[1] * alpha;
+                    b += row[2] * alpha;
+                    a += alpha;
+                }
+            }
+
+            const double samples = static_cast<double>(srcX1 - srcX0) * (srcY1 - srcY0);
+            uint8_t *out = scaled.data() + (static_cast<size_t>(y) * newWidth + x) * 4;
+            out[0] = static_cast<uint8_t>(a > 0 ? r / a : 0);
+            out[1] = static_cast<uint8_t>(a > 0 ? g / a : 0);
+            out[2] = static_cast<uint8_t>(a > 0 ? b / a : 0);
+            out[3] = static_cast<uint8_t>(a / samples);
+        }
+    }
+
+    pixels.swap(scaled);
+    width = newWidth;
+    height = newHeight;
+}
+
+AssetManager::AssetManager(SDL_Renderer *renderer, const int &workerCount) : _renderer(renderer) {
+    _sprites.emplace_back(); // NO_SPRITE
+
+    const int workers = std::max(workerCount, 1);
+    _workers.reserve(workers);
+    for (int i = 0; i < workers; i++) {
+        _workers.emplace_back(&AssetManager::workerLoop, this);
+    }
+}
+
+AssetManager::~AssetManager() {
+    {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _wakeWorkers.notify_all();
+
+    for (auto &worker : _workers) {
+        worker.join();
+    }
+
+    for (const auto &page : _pages) {
+        SDL_DestroyTexture(page._texture);
+    }
+}
+
+void AssetManager::workerLoop() {
+    while (true) {
+        DecodeJob job;
+        {
+            std::unique_lock lock(_mutex);
+            _wakeWorkers.wait(lock, [this] { return _stop || !_jobs.empty(); });
+            if (_stop) {
+                return;
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        DecodedImage image;
+        image._handle = job._handle;
+
+        int channels = 0;
+        if (unsigned char *pixels = stbi_load(job._path.c_str(), &image._width, &image._height, &channels, STBI_rgb_alpha)) {
+            image._pixels.assign(pixels, pixels + static_cast<size_t>(image._width) * image._height * 4);
+            stbi_image_free(pixels);
+            downscale(image._pixels, image._width, image._height, job._maxSide);
+        } else {
+            SDL_Log("stb_image failed to load %s", job._path.c_str());
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            _completed.push_back(std::move(image));
+        }
+        _decoded.notify_all();
+    }
+}
+
+SpriteHandle AssetManager::newSprite(const std::string &key) {
+    const auto handle = static_cast<SpriteHandle>(_sprites.size());
+    _sprites.emplace_back();
+    _handlesByKey.emplace(key, handle);
+    return handle;
+}
+
+AssetManager::Page* AssetManager::createPage(const int &width, const int &height, const bool &shared) {
+    SDL_Texture *texture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, width, height);
+    if (!texture) {
+        SDL_Log("atlas page could not be created: %s", SDL_GetError());
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    // static textures start out undefined, the gaps between sprites have to be transparent
+    if (shared) {
+        const std::vector<uint8_t> clear(static_cast<size_t>(width) * height * 4, 0);
+        SDL_UpdateTexture(texture, nullptr, clear.data(), width * 4);
+    }
+
+    _pages.push_back({ texture, ShelfPacker(width, height), shared });
+    return &_pages.back();
+}
+
+void AssetManager::place(const DecodedImage &image) {
+    Sprite &sprite = _sprites[image._handle];
+    if (image._pixels.empty()) {
+        return; // stays without a page, nothing draws it
+    }
+
+    SDL_Rect placed{};
+    int pageIndex = -1;
+
+    if (image._width <= MAX_ATLAS_SPRITE_SIZE && image._height <= MAX_ATLAS_SPRITE_SIZE) {
+        for (size_t i = 0; i < _pages.size(); i++) {
+            if (_pages[i]._shared && _pages[i]._packer.pack(image._width, image._height, placed)) {
+                pageIndex = static_cast<int>(i);
+                break;
+            }
+        }
+
+        if (pageIndex < 0) {
+            Page *page = createPage(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, true);
+            if (!page || !page->_packer.pack(image._width, image._height, placed)) {
+                return;
+            }
+            pageIndex = static_cast<int>(_pages.size() - 1);
+        }
+    } else {
+        if (!createPage(image._width, image._height, false)) {
+            return;
+        }
+        placed = { 0, 0, image._width, image._height };
+        pageIndex = static_cast<int>(_pages.size() - 1);
+    }
+
+    const Page &page = _pages[pageIndex];
+    SDL_UpdateTexture(page._texture, &placed, image._pixels.data(), image._width * 4);
+
+    float pageW = 0, pageH = 0;
+    SDL_GetTextureSize(page._texture, &pageW, &pageH);
+
+    sprite._page = pageIndex;
+    sprite._width = image._width;
+    sprite._height = image._height;
+    sprite._uv = { placed.x / pageW, placed.y / pageH, placed.w / pageW, placed.h / pageH };
+}
+
+SpriteHandle AssetManager::load(const std::string &relativePath, const int &maxSide) {
+    const std::string key = relativePath + "@" + std::to_string(maxSide);
+    if (const auto it = _handlesByKey.find(key); it != _handlesByKey.end()) {
+        return it->second;
+    }
+
+    const SpriteHandle handle = newSprite(key);
+    _pending++;
+    {
+        std::lock_guard lock(_mutex);
+        _jobs.push_back({ handle, resourcePath(relativePath), maxSide });
+    }
+    _wakeWorkers.notify_one();
+    return handle;
+}
+
+SpriteHandle AssetManager::createSolid(const std::string &name, const SDL_Color &color) {
+    const std::string key = "solid:" + name;
+    if (const auto it = _handlesByKey.find(key); it != _handlesByKey.end()) {
+        return it->second;
+    }
+
+    // a few texels so linear filtering never samples the neighbours
+    constexpr int SIZE = 4;
+    DecodedImage image;
+    image._handle = newSprite(key);
+    image._width = SIZE;
+    image._height = SIZE;
+    image._pixels.resize(SIZE * SIZE * 4);
+    for (int i = 0; i < SIZE * SIZE; i++) {
+        image._pixels[i * 4 + 0] = color.r;
+        image._pixels[i * 4 + 1] = color.g;
+        image._pixels[i * 4 + 2] = color.b;
+        image._pixels[i * 4 + 3] = color.a;
+    }
+    place(image);
+
+    // sample the middle only
+    Sprite &sprite = _sprites[image._handle];
+    if (sprite._page >= 0) {
+        const float insetU = sprite._uv.w / SIZE;
+        const float insetV = sprite._uv.h / SIZE;
+        sprite._uv = { sprite._uv.x + insetU, sprite._uv.y + insetV, sprite._uv.w - insetU * 2, sprite._uv.h - insetV * 2 };
+    }
+    return image._handle;
+}
+
+int AssetManager::update() {
+    std::vector<DecodedImage> completed;
+    {
+        std::lock_guard lock(_mutex);
+        completed.swap(_completed);
+    }
+
+    for (const auto &image : completed) {
+        place(image);
+    }
+
+    _pending -= static_cast<int>(completed.size());
+    return static_cast<int>(completed.size());
+}
+
+void AssetManager::waitAll() {
+    while (_pending > 0) {
+        {
+            std::unique_lock lock(_mutex);
+            _decoded.wait(lock, [this] { return !_completed.empty(); });
+        }
+        update();
+    }
+}
+
+const Sprite& AssetManager::getSprite(const SpriteHandle &handle) const {
+    return handle < _sprites.size() ? _sprites[handle] : _sprites[NO_SPRITE];
+}
@@ -0,0 +1,108 @@
+#ifndef BOUNCEPP_ASSETMANAGER_H
+#define BOUNCEPP_ASSETMANAGER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "ShelfPacker.h"
+#include "../ecs/components/components.hpp"
+
+using namespace components;
+
+// side of one atlas page
+constexpr int ATLAS_PAGE_SIZE = 2048;
+
+// sprites larger than this on either side get a page of their own instead of a spot in the atlas
+constexpr int MAX_ATLAS_SPRITE_SIZE = 512;
+
+// where a sprite ended up: the page texture and its uv rectangle on it
+struct Sprite {
+    int _page = -1; // -1 while it is still being decoded
+    SDL_FRect _uv{};
+    int _width = 0;
+    int _height = 0;
+};
+
+// loads images on worker threads and packs them into shared atlas pages.
+// handles are handed out right away and stay valid for the manager's lifetime, the same path (and size)
+// always gives the same handle. textures are created and updated on the thread calling update()
+class AssetManager {
+
+private:
+    struct DecodeJob {
+        SpriteHandle _handle;
+        std::string _path;
+        int _maxSide;
+    };
+
+    struct DecodedImage {
+        SpriteHandle _handle;
+        std::vector<uint8_t> _pixels; // rgba8, empty when decoding failed
+        int _width = 0;
+        int _height = 0;
+    };
+
+    struct Page {
+        SDL_Texture *_texture;
+        ShelfPacker _packer;
+        bool _shared; // atlas page, false for a page holding one large sprite
+    };
+
+    SDL_Renderer *_renderer;
+
+    // render thread only
+    std::vector<Sprite> _sprites; // index is the handle, slot 0 is NO_SPRITE
+    std::unordered_map<std::string, SpriteHandle> _handlesByKey;
+    std::vector<Page> _pages;
+    int _pending = 0;
+
+    // shared with the workers
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wakeWorkers;
+    std::condition_variable _decoded;
+    std::deque<DecodeJob> _jobs;
+    std::vector<DecodedImage> _completed;
+    bool _stop = false;
+
+    void workerLoop();
+
+    SpriteHandle newSprite(const std::string &key);
+    void place(const DecodedImage &image);
+    Page* createPage(const int &width, const int &height, const bool &shared);
+
+public:
+    explicit AssetManager(SDL_Renderer *renderer, const int &workerCount = 2);
+    ~AssetManager();
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    // path is relative to resources/. maxSide > 0 scales the image down on the worker so neither side exceeds it,
+    // which is how large source art ends up small enough for the atlas
+    SpriteHandle load(const std::string &relativePath, const int &maxSide = 0);
+
+    // a flat colored sprite, placed in the atlas immediately
+    SpriteHandle createSolid(const std::string &name, const SDL_Color &color);
+
+    // uploads everything the workers finished since the last call, returns how many sprites became ready
+    int update();
+
+    // blocks until every requested sprite is ready
+    void waitAll();
+
+    const Sprite& getSprite(const SpriteHandle &handle) const;
+
+    int getPageCount() const { return static_cast<int>(_pages.size()); }
+    SDL_Texture* getPageTexture(const int &page) const { return _pages[page]._texture; }
+};
+
+#endif //BOUNCEPP_ASSETMANAGER_H
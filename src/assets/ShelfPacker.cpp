@@ -0,0 +1,34 @@
+#include "ShelfPacker.h"
+
+ShelfPacker::ShelfPacker(const int &width, const int &height, const int &padding)
+    : _width(width), _height(height), _padding(padding) {
+}
+
+bool ShelfPacker::pack(const int &w, const int &h, SDL_Rect &placed) {
+    const int paddedW = w + _padding * 2;
+    const int paddedH = h + _padding * 2;
+    if (paddedW > _width || paddedH > _height) {
+        return false;
+    }
+
+    // tightest existing shelf wastes the least space
+    Shelf *best = nullptr;
+    for (auto &shelf : _shelves) {
+        if (shelf._height >= paddedH && shelf._usedWidth + paddedW <= _width && (!best || shelf._height < best->_height)) {
+            best = &shelf;
+        }
+    }
+
+    if (!best) {
+        if (_nextShelfY + paddedH > _height) {
+            return false;
+        }
+        _shelves.push_back({ _nextShelfY, paddedH, 0 });
+        _nextShelfY += paddedH;
+        best = &_shelves.back();
+    }
+
+    placed = { best->_usedWidth + _padding, best->_y + _padding, w, h };
+    best->_usedWidth += paddedW;
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef BOUNCEPP_SHELFPACKER_H
+#define BOUNCEPP_SHELFPACKER_H
+
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+// packs rectangles into a fixed size page as rows ("shelves"). a rectangle goes on the lowest shelf
+// that is tall enough and has room, otherwise a new shelf is opened below the last one.
+// good enough for a few hundred sprites of similar height, which is what the atlas holds
+class ShelfPacker {
+
+private:
+    struct Shelf {
+        int _y;
+        int _height;
+        int _usedWidth;
+    };
+
+    int _width;
+    int _height;
+    int _padding;
+    std::vector<Shelf> _shelves;
+    int _nextShelfY = 0;
+
+public:
+    ShelfPacker(const int &width, const int &height, const int &padding = 1);
+
+    // returns false when the page is full
+    bool pack(const int &w, const int &h, SDL_Rect &placed);
+};
+
+#endif //BOUNCEPP_SHELFPACKER_H
@@ -0,0 +1,38 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <entt/entt.hpp>
+
+#include "../ecs/factories/factory.h"
+#include "../ecs/systems/AiSystem.h"
+#include "../ecs/systems/physicsSystem.h"
+#include "../sim/Scenario.h"
+
+void runAiBench(std::vector<BenchmarkResult> &results, const int entities, const int workerCount) {
+    entt::registry registry;
+    PhysicsSystem physicsSystem(10.98f, workerCount);
+    Factory factory({}, physicsSystem.getWorldId());
+    AiSystem aiSystem(registry, physicsSystem.getTaskScheduler());
+
+    ScenarioConfig config;
+    config.balls = 0;
+    config.aiBalls = entities;
+    buildScenario(factory, registry, config);
+
+    // let the balls fall onto the steps so the kernel sees a mix of grounded and airborne balls
+    for (int i = 0; i < 30; i++) {
+        physicsSystem.updatePhysics();
+    }
+
+    const int iterations = entities >= 100000 ? 20 : 200;
+    const auto result = measure("ai_decide", entities, iterations, [&] {
+        aiSystem.processAi();
+    });
+
+    std::printf("ai: %d balls on %d workers, %.2f M decisions/s, %.3f ms/tick\n",
+                entities, physicsSystem.getWorkerCount(), entities / result.nsPerIteration * 1e3, result.nsPerIteration / 1e6);
+
+    results.push_back(result);
+    registry.clear();
+    physicsSystem.destroyWorld();
+}
@@ -0,0 +1,54 @@
+#ifndef BOUNCEPP_BENCHMARK_H
+#define BOUNCEPP_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../core/AllocationCounter.h"
+
+struct BenchmarkResult {
+    std::string name;
+    int entities = 0;
+    int iterations = 0;
+    double nsPerIteration = 0.0;
+    double allocationsPerIteration = 0.0; // operator new and box2d allocations, see core/AllocationCounter.h
+
+    double nsPerEntity() const { return entities > 0 ? nsPerIteration / entities : 0.0; }
+};
+
+// keeps the optimizer from throwing away benchmark loops whose result is otherwise unused
+inline volatile uint64_t benchmarkSink = 0;
+
+// runs function() once to warm caches, then times `iterations` more calls
+template<typename Function>
+BenchmarkResult measure(const std::string &name, const int entities, const int iterations, Function &&function) {
+    function();
+
+    const uint64_t allocationsBefore = getAllocationCount();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        function();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const uint64_t allocations = getAllocationCount() - allocationsBefore;
+
+    BenchmarkResult result;
+    result.name = name;
+    result.entities = entities;
+    result.iterations = iterations;
+    result.nsPerIteration = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    result.allocationsPerIteration = static_cast<double>(allocations) / iterations;
+    return result;
+}
+
+void printResult(const BenchmarkResult &result);
+
+// suites, each appends its results
+void runComponentIterationBench(std::vector<BenchmarkResult> &results, int entities);
+void runAiBench(std::vector<BenchmarkResult> &results, int entities, int workerCount);
+void runSpawnBench(std::vector<BenchmarkResult> &results, int entities);
+void runSystemScalingBench(std::vector<BenchmarkResult> &results, const std::vector<int> &sizes, int workerCount);
+
+#endif //BOUNCEPP_BENCHMARK_H
@@ -0,0 +1,63 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <entt/entt.hpp>
+
+#include "../ecs/components/components.hpp"
+
+using namespace components;
+
+namespace {
+    // the pre-split component layout: creation-time definitions stored next to the body id
+    struct FatPhysicsData {
+        b2BodyDef _bodyDef;
+        b2ShapeDef _shapeDef;
+        b2Polygon _polygon;
+        b2BodyId _physicsBodyId;
+    };
+
+    // same access pattern as GameLogic::applyInputActions: read the body id and the command of every entity
+    template<typename Physics>
+    uint64_t touchBodies(const entt::registry &registry, b2BodyId Physics::*bodyId) {
+        uint64_t checksum = 0;
+        for (auto [entity, physics, metaData] : registry.view<Physics, MetaData>().each()) {
+            checksum += static_cast<uint64_t>((physics.*bodyId).index1) + metaData._currentCommand;
+        }
+        return checksum;
+    }
+
+    template<typename Physics>
+    void populate(entt::registry &registry, const int entities, b2BodyId Physics::*bodyId) {
+        for (int i = 0; i < entities; i++) {
+            const auto entity = registry.create();
+            Physics physics{};
+            (physics.*bodyId).index1 = i + 1;
+            registry.emplace<Physics>(entity, physics);
+            registry.emplace<MetaData>(entity, MetaData{ EntityType::BALL });
+        }
+    }
+}
+
+void runComponentIterationBench(std::vector<BenchmarkResult> &results, const int entities) {
+    const int iterations = entities >= 100000 ? 200 : 2000;
+
+    entt::registry fatRegistry;
+    populate(fatRegistry, entities, &FatPhysicsData::_physicsBodyId);
+
+    entt::registry slimRegistry;
+    populate(slimRegistry, entities, &PhysicsBody::_bodyId);
+
+    const auto fat = measure("iterate_fat_physics_data", entities, iterations, [&] {
+        benchmarkSink = benchmarkSink + touchBodies(fatRegistry, &FatPhysicsData::_physicsBodyId);
+    });
+
+    const auto slim = measure("iterate_physics_body", entities, iterations, [&] {
+        benchmarkSink = benchmarkSink + touchBodies(slimRegistry, &PhysicsBody::_bodyId);
+    });
+
+    std::printf("component iteration: %zu byte vs %zu byte component, %.2fx faster\n",
+                sizeof(FatPhysicsData), sizeof(PhysicsBody), fat.nsPerIteration / slim.nsPerIteration);
+
+    results.push_back(fat);
+    results.push_back(slim);
+}
@@ -0,0 +1,133 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <entt/entt.hpp>
+
+#include "../ecs/factories/BallPool.h"
+#include "../ecs/factories/factory.h"
+#include "../ecs/systems/physicsSystem.h"
+
+namespace {
+    std::vector<SDL_Point> ballGrid(const int count) {
+        constexpr int PER_ROW = 400;
+        std::vector<SDL_Point> positions;
+        positions.reserve(count);
+        for (int i = 0; i < count; i++) {
+            positions.push_back({ (i % PER_ROW) * (BALL_WIDTH + 6), -(i / PER_ROW) * (BALL_HEIGHT + 6) });
+        }
+        return positions;
+    }
+
+    // each run spawns into a fresh world and registry, only the spawning itself is timed
+    template<typename Spawn>
+    BenchmarkResult measureSpawn(const std::string &name, const int entities, const int iterations, Spawn &&spawn) {
+        double totalNs = 0.0;
+        uint64_t totalAllocations = 0;
+
+        for (int i = 0; i <= iterations; i++) {
+            entt::registry registry;
+            PhysicsSystem physicsSystem(10.98f);
+            Factory factory({}, physicsSystem.getWorldId());
+
+            const uint64_t allocationsBefore = getAllocationCount();
+            const auto start = std::chrono::steady_clock::now();
+            spawn(factory, registry);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            // first run warms up the allocator
+            if (i > 0) {
+                totalNs += std::chrono::duration<double, std::nano>(elapsed).count();
+                totalAllocations += getAllocationCount() - allocationsBefore;
+            }
+
+            benchmarkSink = benchmarkSink + registry.storage<PhysicsBody>().size();
+            registry.clear();
+            physicsSystem.destroyWorld();
+        }
+
+        BenchmarkResult result;
+        result.name = name;
+        result.entities = entities;
+        result.iterations = iterations;
+        result.nsPerIteration = totalNs / iterations;
+        result.allocationsPerIteration = static_cast<double>(totalAllocations) / iterations;
+        return result;
+    }
+}
+
+// a spawner replacing a tenth of its balls every tick, with and without a BallPool
+static void runChurnBench(std::vector<BenchmarkResult> &results, const int entities) {
+    const int churn = std::max(entities / 10, 1);
+    const int iterations = entities >= 100000 ? 5 : 50;
+    const std::vector<SDL_Point> positions = ballGrid(entities);
+
+    entt::registry registry;
+    PhysicsSystem physicsSystem(10.98f);
+    Factory factory({}, physicsSystem.getWorldId());
+
+    std::vector<entt::entity> balls;
+    balls.reserve(entities);
+    factory.createBalls(registry, positions, balls, ControlledBy::NOT_CONTROLLED);
+
+    size_t next = 0;
+    const auto destroyed = measure("churn_create_destroy", churn, iterations, [&] {
+        for (int i = 0; i < churn; i++, next = (next + 1) % balls.size()) {
+            const SDL_Point position = positions[next];
+            factory.destroyEntity(registry, balls[next]);
+            balls[next] = factory.createBall(registry, position.x, position.y, ControlledBy::NOT_CONTROLLED);
+        }
+    });
+
+    // room for the balls despawned this tick besides the cooled ones of the last
+    BallPool pool(factory, ControlledBy::NOT_CONTROLLED, 2 * churn);
+    const auto pooled = measure("churn_ball_pool", churn, iterations, [&] {
+        pool.onStep(); // one iteration is one tick, the world would have stepped since the last
+        for (int i = 0; i < churn; i++, next = (next + 1) % balls.size()) {
+            const SDL_Point position = positions[next];
+            pool.despawn(registry, balls[next]);
+            balls[next] = pool.spawn(registry, position.x, position.y);
+        }
+    });
+
+    const BallPoolStats &stats = pool.getStats();
+    std::printf("churn: %d of %d balls per tick, create/destroy %.1f ns/ball %.2f allocs/ball, pool %.1f ns/ball %.2f allocs/ball,"
+                " %.1f%% reused, %zu parked\n", churn, entities,
+                destroyed.nsPerEntity(), destroyed.allocationsPerIteration / churn,
+                pooled.nsPerEntity(), pooled.allocationsPerIteration / churn, stats.reuseRate() * 100.0, stats.parked);
+
+    results.push_back(destroyed);
+    results.push_back(pooled);
+
+    pool.clear(registry);
+    registry.clear();
+    physicsSystem.destroyWorld();
+}
+
+void runSpawnBench(std::vector<BenchmarkResult> &results, const int entities) {
+    const int iterations = entities >= 100000 ? 3 : 20;
+    const std::vector<SDL_Point> positions = ballGrid(entities);
+
+    const auto single = measureSpawn("spawn_balls_one_by_one", entities, iterations, [&](Factory &factory, entt::registry &registry) {
+        for (const auto &position : positions) {
+            factory.createBall(registry, position.x, position.y, ControlledBy::AI);
+        }
+    });
+
+    std::vector<entt::entity> spawned;
+    spawned.reserve(entities);
+    const auto batch = measureSpawn("spawn_balls_batched", entities, iterations, [&](Factory &factory, entt::registry &registry) {
+        spawned.clear();
+        factory.createBalls(registry, positions, spawned, ControlledBy::AI);
+    });
+
+    std::printf("spawn: %d balls, one by one %.2f M/s, batched %.2f M/s (%.2fx)\n", entities,
+                entities / single.nsPerIteration * 1e3, entities / batch.nsPerIteration * 1e3,
+                single.nsPerIteration / batch.nsPerIteration);
+
+    results.push_back(single);
+    results.push_back(batch);
+
+    runChurnBench(results, entities);
+}
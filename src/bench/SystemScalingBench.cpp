@@ -0,0 +1,135 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <entt/entt.hpp>
+
+#include "../ecs/factories/factory.h"
+#include "../ecs/systems/GameLogic.h"
+#include "../ecs/systems/InputSystem.h"
+#include "../ecs/systems/physicsSystem.h"
+#include "../sim/HeadlessSimulation.h"
+
+namespace {
+    constexpr int BALLS_PER_ROW = 400;
+    constexpr int SETTLE_TICKS = 10;
+
+    // fewer iterations as the world grows so every size takes roughly the same time
+    int iterationsFor(const int entities, const int divisor = 1) {
+        return std::clamp(2000000 / std::max(entities, 1) / divisor, 5, 1000);
+    }
+
+    // manual balls stacked in rows above a floor of steps, so every system has real work: commands to apply,
+    // contacts to report and bodies that move
+    void buildWorld(Factory &factory, entt::registry &registry, const int balls) {
+        std::vector<SDL_Point> ballPositions;
+        ballPositions.reserve(balls);
+        for (int i = 0; i < balls; i++) {
+            ballPositions.push_back({ (i % BALLS_PER_ROW) * (BALL_WIDTH + 6), 400 - (i / BALLS_PER_ROW) * (BALL_HEIGHT + 6) });
+        }
+
+        const int floorWidth = std::min(balls, BALLS_PER_ROW) * (BALL_WIDTH + 6);
+        std::vector<SDL_Point> stepPositions;
+        for (int x = -PLATFORM_WIDTH; x <= floorWidth; x += PLATFORM_WIDTH) {
+            stepPositions.push_back({ x, 500 });
+        }
+
+        std::vector<entt::entity> entities;
+        entities.reserve(balls + stepPositions.size());
+        factory.createSteps(registry, stepPositions, entities);
+        factory.createBalls(registry, ballPositions, entities, ControlledBy::MANUAL);
+    }
+
+    // events and transforms only exist for the step that just ran, so each timed call gets a fresh (untimed) step
+    template<typename Function>
+    BenchmarkResult measureAfterStep(const std::string &name, const int entities, const int iterations,
+                                     PhysicsSystem &physicsSystem, Function &&function) {
+        double totalNs = 0.0;
+        uint64_t totalAllocations = 0;
+
+        for (int i = 0; i < iterations; i++) {
+            physicsSystem.updatePhysics();
+
+            const uint64_t allocationsBefore = getAllocationCount();
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            totalNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            totalAllocations += getAllocationCount() - allocationsBefore;
+        }
+
+        BenchmarkResult result;
+        result.name = name;
+        result.entities = entities;
+        result.iterations = iterations;
+        result.nsPerIteration = totalNs / iterations;
+        result.allocationsPerIteration = static_cast<double>(totalAllocations) / iterations;
+        return result;
+    }
+
+    void runSystems(std::vector<BenchmarkResult> &results, const int entities, const int workerCount) {
+        entt::registry registry;
+        PhysicsSystem physicsSystem(10.98f, workerCount);
+        Factory factory({}, physicsSystem.getWorldId());
+        InputSystem inputSystem;
+        GameLogic gameLogic;
+
+        buildWorld(factory, registry, entities);
+        for (int i = 0; i < SETTLE_TICKS; i++) {
+            physicsSystem.updatePhysics();
+        }
+
+        const int iterations = iterationsFor(entities);
+        const int stepIterations = iterationsFor(entities, 10);
+
+        results.push_back(measure("processInput", entities, iterations, [&] {
+            inputSystem.processInput(registry);
+        }));
+
+        results.push_back(measure("applyInputActions", entities, iterations, [&] {
+            gameLogic.applyInputActions(registry);
+        }));
+
+        results.push_back(measureAfterStep("checkPhysicsEvents", entities, stepIterations, physicsSystem, [&] {
+            gameLogic.checkPhysicsEvents(physicsSystem.getWorldId(), registry);
+        }));
+
+        results.push_back(measure("updatePhysics", entities, stepIterations, [&] {
+            physicsSystem.updatePhysics();
+        }));
+
+        results.push_back(measureAfterStep("syncPhysicsWithRendering", entities, stepIterations, physicsSystem, [&] {
+            physicsSystem.syncPhysicsWithRendering(registry);
+        }));
+
+        registry.clear();
+        physicsSystem.destroyWorld();
+    }
+
+    // every system in order, as BouncePP_sim runs them
+    void runHeadlessFrame(std::vector<BenchmarkResult> &results, const int entities, const int workerCount) {
+        ScenarioConfig config;
+        config.balls = entities;
+
+        HeadlessSimulation simulation(config, workerCount);
+        simulation.run(SETTLE_TICKS);
+
+        results.push_back(measure("headless_frame", entities, iterationsFor(entities, 10), [&] {
+            simulation.run(1);
+        }));
+    }
+}
+
+void runSystemScalingBench(std::vector<BenchmarkResult> &results, const std::vector<int> &sizes, const int workerCount) {
+    for (const int entities : sizes) {
+        const size_t first = results.size();
+
+        runSystems(results, entities, workerCount);
+        runHeadlessFrame(results, entities, workerCount);
+
+        std::printf("scaling: %d entities\n", entities);
+        for (size_t i = first; i < results.size(); i++) {
+            std::printf("  %-26s %12.1f ns/tick %8.3f ns/entity %8.1f allocs/tick\n", results[i].name.c_str(),
+                        results[i].nsPerIteration, results[i].nsPerEntity(), results[i].allocationsPerIteration);
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "bench/Benchmark.h"
+#include "core/TaskScheduler.h"
+
+// bump when result names or their meaning change, so stored results are only compared like for like
+constexpr int BENCH_FORMAT_VERSION = 1;
+
+void printResult(const BenchmarkResult &result) {
+    std::printf("%-32s %8d entities %12.1f ns/iter %8.3f ns/entity %10.1f allocs/iter\n",
+                result.name.c_str(), result.entities, result.nsPerIteration, result.nsPerEntity(), result.allocationsPerIteration);
+}
+
+static bool writeJson(const std::string &path, const std::vector<BenchmarkResult> &results, const int workers) {
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::printf("could not open %s for writing\n", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "{\n  \"version\": %d,\n  \"workers\": %d,\n  \"results\": [\n", BENCH_FORMAT_VERSION, workers);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult &result = results[i];
+        std::fprintf(file, "    {\"name\": \"%s\", \"entities\": %d, \"iterations\": %d, \"ns_per_iteration\": %.1f, "
+                           "\"ns_per_entity\": %.4f, \"allocations_per_iteration\": %.2f}%s\n",
+                     result.name.c_str(), result.entities, result.iterations, result.nsPerIteration, result.nsPerEntity(),
+                     result.allocationsPerIteration, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+static bool writeCsv(const std::string &path, const std::vector<BenchmarkResult> &results) {
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::printf("could not open %s for writing\n", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "name,entities,iterations,ns_per_iteration,ns_per_entity,allocations_per_iteration\n");
+    for (const auto &result : results) {
+        std::fprintf(file, "%s,%d,%d,%.1f,%.4f,%.2f\n", result.name.c_str(), result.entities, result.iterations,
+                     result.nsPerIteration, result.nsPerEntity(), result.allocationsPerIteration);
+    }
+    return std::fclose(file) == 0;
+}
+
+// "1,1000,10000" -> { 1, 1000, 10000 }
+static std::vector<int> parseSizes(const char *list) {
+    std::vector<int> sizes;
+    for (const char *cursor = list; *cursor;) {
+        char *end = nullptr;
+        const long size = std::strtol(cursor, &end, 10);
+        if (end == cursor || size <= 0) {
+            return {};
+        }
+        sizes.push_back(static_cast<int>(size));
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return sizes;
+}
+
+static void printUsage(const char *program) {
+    std::printf("usage: %s [--suite all|micro|scaling] [--entities N] [--sizes N,N,...] [--workers N]"
+                " [--json FILE] [--csv FILE]\n", program);
+}
+
+int main(int argc, char* argv[])
+{
+    installAllocationCounter();
+
+    int entities = 100000;
+    int workers = TaskScheduler::getDefaultWorkerCount();
+    std::string suite = "all";
+    std::vector<int> sizes = { 1, 1000, 10000, 100000 };
+    std::string jsonPath;
+    std::string csvPath;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--entities") == 0 && i + 1 < argc) {
+            entities = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--suite") == 0 && i + 1 < argc) {
+            suite = argv[++i];
+        } else if (std::strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            sizes = parseSizes(argv[++i]);
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (sizes.empty() || (suite != "all" && suite != "micro" && suite != "scaling")) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<BenchmarkResult> results;
+
+    if (suite == "all" || suite == "micro") {
+        runComponentIterationBench(results, entities);
+        runAiBench(results, entities, workers);
+        runSpawnBench(results, entities);
+    }
+
+    // each system on its own at every size, then a full tick
+    if (suite == "all" || suite == "scaling") {
+        runSystemScalingBench(results, sizes, workers);
+    }
+
+    for (const auto &result : results) {
+        printResult(result);
+    }
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, results, workers)) {
+        return 1;
+    }
+    if (!csvPath.empty() && !writeCsv(csvPath, results)) {
+        return 1;
+    }
+
+    return 0;
+}
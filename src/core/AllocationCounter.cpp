@@ -0,0 +1,110 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <box2d/box2d.h>
+
+#include "Memory.h"
+
+// replaces the global operator new of the executables that link this file (bench and headless simulation),
+// the game and BouncePP_core keep the default
+
+namespace {
+    std::atomic<uint64_t> allocations{0};
+
+    void* allocate(const std::size_t size) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        if (void *memory = std::malloc(size > 0 ? size : 1)) {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* allocateAligned(const std::size_t size, const std::size_t alignment) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t rounded = (size + alignment - 1) / alignment * alignment; // aligned_alloc wants a multiple
+#ifdef _WIN32
+        return _aligned_malloc(rounded > 0 ? rounded : alignment, alignment);
+#else
+        return std::aligned_alloc(alignment, rounded > 0 ? rounded : alignment);
+#endif
+    }
+
+    void freeAligned(void *memory) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+
+    void* box2dAlloc(const unsigned int size, const int alignment) {
+        return allocateAligned(size, static_cast<std::size_t>(alignment));
+    }
+
+    void box2dFree(void *memory) {
+        freeAligned(memory);
+    }
+}
+
+void* operator new(const std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](const std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    if (void *memory = allocateAligned(size, static_cast<std::size_t>(alignment))) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept {
+    freeAligned(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept {
+    freeAligned(memory);
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept {
+    freeAligned(memory);
+}
+
+void operator delete[](void *memory, std::size_t, std::align_val_t) noexcept {
+    freeAligned(memory);
+}
+
+void installAllocationCounter() {
+    b2SetAllocator(box2dAlloc, box2dFree);
+}
+
+uint64_t getAllocationCount() {
+    // component pools and scratch arenas take memoryAllocate's pool instead of operator new
+    return allocations.load(std::memory_order_relaxed) + MemoryBudget::process().getAllocationCount();
+}
@@ -0,0 +1,15 @@
+#ifndef BOUNCEPP_ALLOCATIONCOUNTER_H
+#define BOUNCEPP_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+// not part of BouncePP_core: AllocationCounter.cpp replaces the global operator new, so only executables
+// that want every allocation counted list it in their sources
+
+// counts every operator new of the executable and every tracked memoryAllocate. installAllocationCounter
+// also routes box2d's allocations through the counter instead of the memory pool, call it instead of
+// installBox2dAllocator and before the first world is created
+void installAllocationCounter();
+uint64_t getAllocationCount();
+
+#endif //BOUNCEPP_ALLOCATIONCOUNTER_H
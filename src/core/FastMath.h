@@ -0,0 +1,43 @@
+#ifndef BOUNCEPP_FASTMATH_H
+#define BOUNCEPP_FASTMATH_H
+
+#include <bit>
+#include <cstdint>
+
+// branch-free float approximations meant for loops the compiler can vectorise.
+// good enough for drawing, never feed them back into the simulation
+
+namespace fastmath {
+    constexpr uint32_t SIGN_BIT = 0x80000000u;
+
+    inline uint32_t bits(const float value) { return std::bit_cast<uint32_t>(value); }
+    inline float fromBits(const uint32_t value) { return std::bit_cast<float>(value); }
+
+    // all ones where the condition holds, integer selects vectorise even without -ffast-math
+    inline uint32_t mask(const bool condition) { return condition ? 0xFFFFFFFFu : 0u; }
+
+    // where mask is set returns offset - value, otherwise value
+    inline float reflect(const float value, const float offset, const uint32_t mask) {
+        return fromBits(bits(value) ^ (mask & SIGN_BIT)) + fromBits(bits(offset) & mask);
+    }
+}
+
+// atan2 in radians, max error about 2e-4 rad (0.012 degrees)
+inline float fastAtan2(const float y, const float x) {
+    using namespace fastmath;
+
+    const uint32_t absX = bits(x) & ~SIGN_BIT;
+    const uint32_t absY = bits(y) & ~SIGN_BIT;
+
+    // positive floats order like their bit patterns, so the octant test stays in integer lanes
+    const uint32_t steep = mask(absY > absX);
+    const float ratio = fromBits((absY & ~steep) | (absX & steep)) / (fromBits((absX & ~steep) | (absY & steep)) + 1e-30f);
+    const float squared = ratio * ratio;
+
+    float angle = ((-0.0464964749f * squared + 0.15931422f) * squared - 0.327622764f) * squared * ratio + ratio;
+    angle = reflect(angle, 1.57079637f, steep);
+    angle = reflect(angle, 3.14159274f, mask((bits(x) & SIGN_BIT) != 0));
+    return fromBits(bits(angle) ^ (bits(y) & SIGN_BIT));
+}
+
+#endif //BOUNCEPP_FASTMATH_H
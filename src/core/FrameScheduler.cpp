@@ -0,0 +1,32 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+int FrameScheduler::advance(double frameSeconds, const double &timeStep) {
+    frameSeconds = std::clamp(frameSeconds, 0.0, _maxFrameTime);
+    _accumulator += frameSeconds;
+
+    int steps = static_cast<int>(std::floor(_accumulator / timeStep));
+    if (steps > _maxStepsPerFrame) {
+        // catch-up cap hit, keep only the partial step so interpolation stays valid
+        steps = _maxStepsPerFrame;
+        _accumulator = std::fmod(_accumulator, timeStep);
+    } else {
+        _accumulator -= steps * timeStep;
+    }
+
+    return steps;
+}
+
+float FrameScheduler::getAlpha(const double &timeStep) const {
+    return static_cast<float>(std::clamp(_accumulator / timeStep, 0.0, 1.0));
+}
+
+void FrameScheduler::setMaxStepsPerFrame(const int &maxStepsPerFrame) {
+    _maxStepsPerFrame = std::max(1, maxStepsPerFrame);
+}
+
+void FrameScheduler::reset() {
+    _accumulator = 0.0;
+}
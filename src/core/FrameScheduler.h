@@ -0,0 +1,28 @@
+#ifndef BOUNCEPP_FRAMESCHEDULER_H
+#define BOUNCEPP_FRAMESCHEDULER_H
+
+// fixed timestep accumulator, decides how many simulation ticks a rendered frame has to run
+class FrameScheduler {
+
+private:
+    double _accumulator = 0.0;
+
+    // frames longer than this (debugger, window drag) are clamped so the sim does not try to catch up on them
+    double _maxFrameTime = 0.25;
+
+    // upper bound on ticks per frame, anything beyond it is dropped instead of spiralling
+    int _maxStepsPerFrame = 8;
+
+public:
+    // adds the wall-clock frame time and returns the number of fixed steps to run this frame
+    int advance(double frameSeconds, const double &timeStep);
+
+    // fraction of a step left over in the accumulator, 0 = previous transform, 1 = current transform
+    float getAlpha(const double &timeStep) const;
+
+    void setMaxStepsPerFrame(const int &maxStepsPerFrame);
+
+    void reset();
+};
+
+#endif //BOUNCEPP_FRAMESCHEDULER_H
@@ -0,0 +1,34 @@
+#ifndef BOUNCEPP_MAPPEDFILE_H
+#define BOUNCEPP_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// read-only memory mapping of a whole file, pages are faulted in by the os as they are touched
+class MappedFile {
+
+private:
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+
+#ifdef _WIN32
+    void *_file = nullptr;
+    void *_mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    const uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+};
+
+#endif //BOUNCEPP_MAPPEDFILE_H
@@ -0,0 +1,248 @@
+#include "Memory.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <mutex>
+
+#include <box2d/box2d.h>
+
+namespace {
+    // in front of every block, as big as the largest alignment so the payload keeps the block's alignment
+    struct alignas(MEMORY_MAX_ALIGNMENT) BlockHeader {
+        MemoryBudget *_budget; // charged besides the process budget, nullptr when none was set
+        uint64_t _size;        // as requested
+        uint32_t _sizeClass;
+        MemorySubsystem _subsystem;
+    };
+
+    static_assert(sizeof(BlockHeader) == MEMORY_MAX_ALIGNMENT);
+
+    constexpr size_t MIN_BLOCK_SIZE = 64;
+    constexpr int SIZE_CLASS_COUNT = 11; // 64 B to 64 KiB, powers of two
+    constexpr uint32_t UNPOOLED = UINT32_MAX;
+
+    static_assert(MIN_BLOCK_SIZE << (SIZE_CLASS_COUNT - 1) == MEMORY_POOL_MAX_BLOCK);
+
+    // overlays a block while it sits in the free list
+    struct FreeBlock {
+        FreeBlock *_next;
+    };
+
+    struct alignas(64) SizeClass {
+        std::mutex _mutex;
+        FreeBlock *_free = nullptr;
+        std::byte *_chunk = nullptr; // not yet handed out part of the newest chunk
+        size_t _chunkLeft = 0;
+    };
+
+    // constant initialised, so usable from static constructors of other translation units
+    SizeClass sizeClasses[SIZE_CLASS_COUNT];
+    std::atomic<uint64_t> reservedBytes{0};
+    MemoryBudget processBudget;
+
+    thread_local MemoryBudget *currentBudget = nullptr;
+
+    void* heapAllocate(const size_t size) {
+        const size_t rounded = (size + MEMORY_MAX_ALIGNMENT - 1) / MEMORY_MAX_ALIGNMENT * MEMORY_MAX_ALIGNMENT;
+#ifdef _WIN32
+        return _aligned_malloc(rounded, MEMORY_MAX_ALIGNMENT);
+#else
+        return std::aligned_alloc(MEMORY_MAX_ALIGNMENT, rounded);
+#endif
+    }
+
+    void heapFree(void *memory) {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+
+    uint32_t sizeClassOf(const size_t blockSize) {
+        uint32_t sizeClass = 0;
+        while ((MIN_BLOCK_SIZE << sizeClass) < blockSize) {
+            sizeClass++;
+        }
+        return sizeClass;
+    }
+
+    std::byte* takeBlock(const uint32_t sizeClass) {
+        SizeClass &pool = sizeClasses[sizeClass];
+        const size_t blockSize = MIN_BLOCK_SIZE << sizeClass;
+
+        const std::lock_guard lock(pool._mutex);
+        if (FreeBlock *block = pool._free) {
+            pool._free = block->_next;
+            return reinterpret_cast<std::byte*>(block);
+        }
+
+        if (pool._chunkLeft < blockSize) {
+            const size_t chunkSize = blockSize * MEMORY_POOL_BLOCKS_PER_CHUNK;
+            pool._chunk = static_cast<std::byte*>(heapAllocate(chunkSize));
+            if (pool._chunk == nullptr) {
+                pool._chunkLeft = 0;
+                return nullptr;
+            }
+            pool._chunkLeft = chunkSize;
+            reservedBytes.fetch_add(chunkSize, std::memory_order_relaxed);
+        }
+
+        std::byte *block = pool._chunk;
+        pool._chunk += blockSize;
+        pool._chunkLeft -= blockSize;
+        return block;
+    }
+
+    void returnBlock(std::byte *block, const uint32_t sizeClass) {
+        SizeClass &pool = sizeClasses[sizeClass];
+
+        const std::lock_guard lock(pool._mutex);
+        auto *freeBlock = reinterpret_cast<FreeBlock*>(block);
+        freeBlock->_next = pool._free;
+        pool._free = freeBlock;
+    }
+
+    void* box2dAllocate(const unsigned int size, const int alignment) {
+        return memoryAllocate(size, static_cast<size_t>(alignment), MEMORY_PHYSICS);
+    }
+
+    void box2dFree(void *memory) {
+        memoryFree(memory);
+    }
+}
+
+const char* memorySubsystemName(const MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MEMORY_PHYSICS:
+            return "physics";
+        case MEMORY_ECS:
+            return "ecs";
+        case MEMORY_SCRATCH:
+            return "scratch";
+    }
+    return "unknown";
+}
+
+// MemoryBudget
+
+MemoryBudget& MemoryBudget::process() {
+    return processBudget;
+}
+
+MemoryBudget* MemoryBudget::current() {
+    return currentBudget;
+}
+
+void MemoryBudget::charge(const MemorySubsystem &subsystem, const uint64_t &bytes) {
+    Counters &counters = _counters[subsystem];
+    const uint64_t live = counters._bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    uint64_t peak = counters._peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !counters._peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+    counters._allocations.fetch_add(1, std::memory_order_relaxed);
+    _bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void MemoryBudget::release(const MemorySubsystem &subsystem, const uint64_t &bytes) {
+    Counters &counters = _counters[subsystem];
+    counters._bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    counters._frees.fetch_add(1, std::memory_order_relaxed);
+    _bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryUsage MemoryBudget::getUsage(const MemorySubsystem &subsystem) const {
+    const Counters &counters = _counters[subsystem];
+
+    MemoryUsage usage;
+    usage.bytes = counters._bytes.load(std::memory_order_relaxed);
+    usage.peakBytes = counters._peakBytes.load(std::memory_order_relaxed);
+    usage.allocations = counters._allocations.load(std::memory_order_relaxed);
+    usage.frees = counters._frees.load(std::memory_order_relaxed);
+    return usage;
+}
+
+uint64_t MemoryBudget::getAllocationCount() const {
+    uint64_t allocations = 0;
+    for (const auto &counters : _counters) {
+        allocations += counters._allocations.load(std::memory_order_relaxed);
+    }
+    return allocations;
+}
+
+// MemoryBudgetScope
+
+MemoryBudgetScope::MemoryBudgetScope(MemoryBudget *budget) : _previous(currentBudget) {
+    if (budget) {
+        currentBudget = budget;
+    }
+}
+
+MemoryBudgetScope::~MemoryBudgetScope() {
+    currentBudget = _previous;
+}
+
+// allocation
+
+void* memoryAllocate(const size_t size, const size_t alignment, const MemorySubsystem subsystem) {
+    assert(alignment <= MEMORY_MAX_ALIGNMENT);
+    (void)alignment; // every block is MEMORY_MAX_ALIGNMENT aligned
+
+    const size_t blockSize = size + sizeof(BlockHeader);
+
+    std::byte *block;
+    uint32_t sizeClass;
+    if (blockSize <= MEMORY_POOL_MAX_BLOCK) {
+        sizeClass = sizeClassOf(blockSize);
+        block = takeBlock(sizeClass);
+    } else {
+        sizeClass = UNPOOLED;
+        block = static_cast<std::byte*>(heapAllocate(blockSize));
+        if (block) {
+            reservedBytes.fetch_add(blockSize, std::memory_order_relaxed);
+        }
+    }
+
+    if (block == nullptr) {
+        return nullptr;
+    }
+
+    MemoryBudget *budget = currentBudget != &processBudget ? currentBudget : nullptr;
+    new (block) BlockHeader{ budget, size, sizeClass, subsystem };
+
+    processBudget.charge(subsystem, size);
+    if (budget) {
+        budget->charge(subsystem, size);
+    }
+    return block + sizeof(BlockHeader);
+}
+
+void memoryFree(void *memory) {
+    if (memory == nullptr) {
+        return;
+    }
+
+    std::byte *block = static_cast<std::byte*>(memory) - sizeof(BlockHeader);
+    const BlockHeader header = *reinterpret_cast<const BlockHeader*>(block);
+
+    processBudget.release(header._subsystem, header._size);
+    if (header._budget) {
+        header._budget->release(header._subsystem, header._size);
+    }
+
+    if (header._sizeClass == UNPOOLED) {
+        reservedBytes.fetch_sub(header._size + sizeof(BlockHeader), std::memory_order_relaxed);
+        heapFree(block);
+        return;
+    }
+    returnBlock(block, header._sizeClass);
+}
+
+uint64_t getMemoryReservedBytes() {
+    return reservedBytes.load(std::memory_order_relaxed);
+}
+
+void installBox2dAllocator() {
+    b2SetAllocator(box2dAllocate, box2dFree);
+}
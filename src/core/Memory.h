@@ -0,0 +1,142 @@
+#ifndef BOUNCEPP_MEMORY_H
+#define BOUNCEPP_MEMORY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+enum MemorySubsystem : uint8_t {
+    MEMORY_PHYSICS = 0, // box2d, through installBox2dAllocator
+    MEMORY_ECS = 1,     // component pools, see TrackedAllocator
+    MEMORY_SCRATCH = 2  // per-frame ScratchArena blocks
+};
+
+static constexpr int MEMORY_SUBSYSTEM_COUNT = 3;
+
+// blocks up to this size (header included) come from size-class free lists, bigger ones straight from the heap
+constexpr size_t MEMORY_POOL_MAX_BLOCK = 64 * 1024;
+
+// pooled blocks are carved out of chunks holding this many, chunks are kept until the process exits
+constexpr size_t MEMORY_POOL_BLOCKS_PER_CHUNK = 16;
+
+// largest alignment memoryAllocate supports, box2d asks for 32
+constexpr size_t MEMORY_MAX_ALIGNMENT = 64;
+
+const char* memorySubsystemName(MemorySubsystem subsystem);
+
+struct MemoryUsage {
+    uint64_t bytes = 0;     // live, as requested by the caller
+    uint64_t peakBytes = 0;
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+};
+
+// live byte and allocation counters per subsystem. every tracked allocation is charged to the process budget
+// and to the budget of the thread that made it, if one is set with MemoryBudgetScope. a HeadlessSimulation owns
+// one per world, so matches hosted side by side are counted apart.
+// the limit is soft: allocations are never refused, exceeded() reports that the world went over.
+// not counted: the registry's entity storage (a few bytes per entity, EnTT creates it with the registry's
+// std::allocator) and plain std containers
+class MemoryBudget {
+
+private:
+    struct Counters {
+        std::atomic<uint64_t> _bytes{0};
+        std::atomic<uint64_t> _peakBytes{0};
+        std::atomic<uint64_t> _allocations{0};
+        std::atomic<uint64_t> _frees{0};
+    };
+
+    std::array<Counters, MEMORY_SUBSYSTEM_COUNT> _counters;
+    std::atomic<uint64_t> _bytes{0}; // all subsystems
+    uint64_t _limit = 0;             // 0 is no limit
+
+public:
+    MemoryBudget() = default;
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    static MemoryBudget& process();
+
+    // set by the innermost MemoryBudgetScope on this thread, nullptr outside of any
+    static MemoryBudget* current();
+
+    void charge(const MemorySubsystem &subsystem, const uint64_t &bytes);
+    void release(const MemorySubsystem &subsystem, const uint64_t &bytes);
+
+    MemoryUsage getUsage(const MemorySubsystem &subsystem) const;
+    uint64_t getBytes() const { return _bytes.load(std::memory_order_relaxed); }
+    uint64_t getAllocationCount() const;
+
+    void setLimit(const uint64_t &bytes) { _limit = bytes; }
+    uint64_t getLimit() const { return _limit; }
+    bool exceeded() const { return _limit > 0 && getBytes() > _limit; }
+};
+
+// charges this thread's tracked allocations to budget until the scope ends, nullptr keeps the enclosing budget
+class MemoryBudgetScope {
+
+private:
+    MemoryBudget *_previous;
+
+public:
+    explicit MemoryBudgetScope(MemoryBudget *budget);
+    ~MemoryBudgetScope();
+
+    MemoryBudgetScope(const MemoryBudgetScope&) = delete;
+    MemoryBudgetScope& operator=(const MemoryBudgetScope&) = delete;
+};
+
+// pooled and counted allocation, thread safe, nullptr when the heap is out of memory.
+// the block remembers the budget it was charged to, so it can be freed from any thread
+void* memoryAllocate(size_t size, size_t alignment, MemorySubsystem subsystem);
+void memoryFree(void *memory);
+
+// bytes the pool holds in chunks and in unpooled blocks, used or not
+uint64_t getMemoryReservedBytes();
+
+// routes box2d's allocations through memoryAllocate, call before the first world is created
+void installBox2dAllocator();
+
+// std allocator over memoryAllocate, lets containers and EnTT storages be counted under a subsystem
+template<typename T, MemorySubsystem Subsystem = MEMORY_ECS>
+struct TrackedAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template<typename U>
+    struct rebind {
+        using other = TrackedAllocator<U, Subsystem>;
+    };
+
+    TrackedAllocator() noexcept = default;
+
+    template<typename U>
+    TrackedAllocator(const TrackedAllocator<U, Subsystem>&) noexcept {}
+
+    // EnTT hands every storage the registry's std::allocator
+    template<typename U>
+    TrackedAllocator(const std::allocator<U>&) noexcept {}
+
+    T* allocate(const size_t count) {
+        if (void *memory = memoryAllocate(count * sizeof(T), alignof(T), Subsystem)) {
+            return static_cast<T*>(memory);
+        }
+        throw std::bad_alloc();
+    }
+
+    void deallocate(T *memory, size_t) noexcept {
+        memoryFree(memory);
+    }
+
+    template<typename U>
+    bool operator==(const TrackedAllocator<U, Subsystem>&) const noexcept { return true; }
+};
+
+#endif //BOUNCEPP_MEMORY_H
@@ -0,0 +1,9 @@
+#include "Paths.h"
+
+#include <SDL3/SDL.h>
+
+std::string resourcePath(const std::string &relativePath) {
+    // already ends with a separator, null if the platform cannot tell us
+    const char *basePath = SDL_GetBasePath();
+    return std::string(basePath ? basePath : "") + "resources/" + relativePath;
+}
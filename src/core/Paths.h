@@ -0,0 +1,9 @@
+#ifndef BOUNCEPP_PATHS_H
+#define BOUNCEPP_PATHS_H
+
+#include <string>
+
+// absolute path of a file under resources/, which the build copies next to the executables
+std::string resourcePath(const std::string &relativePath);
+
+#endif //BOUNCEPP_PATHS_H
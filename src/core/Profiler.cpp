@@ -0,0 +1,314 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// frames the overlay averages over
+static constexpr size_t OVERLAY_FRAMES = 120;
+
+// overlay graph height corresponds to this frame time
+static constexpr double OVERLAY_GRAPH_MS = 33.3;
+
+// distinct scope names the overlay and csv keep apart, more than the game has
+static constexpr size_t MAX_SCOPE_NAMES = 48;
+
+struct ScopeTotal {
+    const char *_name;
+    uint64_t _totalNs;
+};
+
+// scopes with the same name are summed, names are literals so compare contents, not pointers
+static void addScopeTotal(std::array<ScopeTotal, MAX_SCOPE_NAMES> &totals, size_t &count, const char *name, const uint64_t ns) {
+    for (size_t i = 0; i < count; i++) {
+        if (totals[i]._name == name || std::strcmp(totals[i]._name, name) == 0) {
+            totals[i]._totalNs += ns;
+            return;
+        }
+    }
+    if (count < totals.size()) {
+        totals[count++] = { name, ns };
+    }
+}
+
+Profiler::Profiler() : _frames(PROFILER_FRAME_HISTORY), _originNs(nowNs()) {
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t Profiler::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+size_t Profiler::historySize() const {
+    return static_cast<size_t>(std::min<uint64_t>(_frameCount, PROFILER_FRAME_HISTORY));
+}
+
+const FrameSample& Profiler::historyFrame(const size_t &index) const {
+    const uint64_t frame = _frameCount - historySize() + index;
+    return _frames[frame % PROFILER_FRAME_HISTORY];
+}
+
+void Profiler::beginFrame() {
+    if (_current) {
+        endFrame();
+    }
+
+    _owner = std::this_thread::get_id();
+    _current = &_frames[_frameCount % PROFILER_FRAME_HISTORY];
+    _current->_frame = _frameCount;
+    _current->_startNs = nowNs() - _originNs;
+    _current->_durationNs = 0;
+    _current->_physics = PhysicsProfileSample();
+    _current->_scopeCount = 0;
+    _current->_droppedScopes = 0;
+    _depth = 0;
+}
+
+void Profiler::endFrame() {
+    if (!_current) {
+        return;
+    }
+
+    _current->_durationNs = nowNs() - _originNs - _current->_startNs;
+    _current = nullptr;
+    _frameCount++;
+}
+
+int Profiler::beginScope(const char *name) {
+    if (!_current || std::this_thread::get_id() != _owner) {
+        return -1;
+    }
+
+    if (_current->_scopeCount >= PROFILER_MAX_SCOPES) {
+        _current->_droppedScopes++;
+        return -1;
+    }
+
+    const int slot = _current->_scopeCount++;
+    _current->_scopes[slot] = { name, nowNs() - _originNs, 0, _depth++ };
+    return slot;
+}
+
+void Profiler::endScope(const int &slot) {
+    // a scope still open across endFrame belongs to a frame that is already closed
+    if (slot < 0 || !_current || slot >= _current->_scopeCount) {
+        return;
+    }
+
+    ProfileScopeSample &scope = _current->_scopes[slot];
+    scope._durationNs = static_cast<uint32_t>(nowNs() - _originNs - scope._startNs);
+    _depth--;
+}
+
+void Profiler::recordPhysics(const b2WorldId &worldId) {
+    if (!_current || std::this_thread::get_id() != _owner) {
+        return;
+    }
+
+    const b2Profile profile = b2World_GetProfile(worldId);
+    const b2Counters counters = b2World_GetCounters(worldId);
+
+    PhysicsProfileSample &physics = _current->_physics;
+    physics._steps++;
+    physics._step += profile.step;
+    physics._pairs += profile.pairs;
+    physics._collide += profile.collide;
+    physics._solve += profile.solve;
+    physics._solveConstraints += profile.solveConstraints;
+    physics._transforms += profile.transforms;
+    physics._refit += profile.refit;
+    physics._sleepIslands += profile.sleepIslands;
+
+    physics._bodyCount = counters.bodyCount;
+    physics._contactCount = counters.contactCount;
+    physics._islandCount = counters.islandCount;
+    physics._taskCount = counters.taskCount;
+    physics._byteCount = counters.byteCount;
+}
+
+const FrameSample* Profiler::getLastFrame() const {
+    return _frameCount > 0 ? &historyFrame(historySize() - 1) : nullptr;
+}
+
+void Profiler::drawOverlay(SDL_Renderer *renderer) const {
+    if (!_overlayVisible || _frameCount == 0) {
+        return;
+    }
+
+    const size_t history = historySize();
+    const size_t frames = std::min(history, OVERLAY_FRAMES);
+
+    uint64_t totalNs = 0;
+    uint64_t worstNs = 0;
+    PhysicsProfileSample physics;
+    std::array<ScopeTotal, MAX_SCOPE_NAMES> scopes{};
+    size_t scopeCount = 0;
+
+    for (size_t i = history - frames; i < history; i++) {
+        const FrameSample &frame = historyFrame(i);
+        totalNs += frame._durationNs;
+        worstNs = std::max(worstNs, frame._durationNs);
+        physics._steps += frame._physics._steps;
+        physics._step += frame._physics._step;
+        physics._collide += frame._physics._collide;
+        physics._solve += frame._physics._solve;
+
+        for (int s = 0; s < frame._scopeCount; s++) {
+            addScopeTotal(scopes, scopeCount, frame._scopes[s]._name, frame._scopes[s]._durationNs);
+        }
+    }
+
+    const double perFrame = 1.0 / static_cast<double>(frames);
+    const FrameSample &last = historyFrame(history - 1);
+
+    constexpr float LINE = 10.0f;
+    constexpr float GRAPH_HEIGHT = 60.0f;
+    const float panelHeight = LINE * (5.0f + static_cast<float>(scopeCount)) + GRAPH_HEIGHT + 16.0f;
+    const SDL_FRect panel = { 8.0f, 8.0f, 360.0f, panelHeight };
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &panel);
+
+    float y = panel.y + 4.0f;
+    const float x = panel.x + 4.0f;
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+
+    SDL_RenderDebugTextFormat(renderer, x, y, "frame %6.2f ms avg %6.2f ms max (%zu frames)",
+                              totalNs * perFrame / 1e6, worstNs / 1e6, frames);
+    y += LINE;
+    for (size_t i = 0; i < scopeCount; i++) {
+        SDL_RenderDebugTextFormat(renderer, x, y, "  %-26s %6.3f ms", scopes[i]._name, scopes[i]._totalNs * perFrame / 1e6);
+        y += LINE;
+    }
+    SDL_RenderDebugTextFormat(renderer, x, y, "box2d %.1f steps step %.3f collide %.3f solve %.3f ms",
+                              physics._steps * perFrame, physics._step * perFrame, physics._collide * perFrame, physics._solve * perFrame);
+    y += LINE;
+    SDL_RenderDebugTextFormat(renderer, x, y, "bodies %d contacts %d islands %d tasks %d",
+                              last._physics._bodyCount, last._physics._contactCount, last._physics._islandCount, last._physics._taskCount);
+    y += LINE;
+    if (last._droppedScopes > 0) {
+        SDL_RenderDebugTextFormat(renderer, x, y, "%d scopes dropped last frame", last._droppedScopes);
+    }
+    y += LINE * 1.5f;
+
+    // one bar per frame, red past the 60 Hz budget
+    const float barWidth = (panel.w - 8.0f) / static_cast<float>(OVERLAY_FRAMES);
+    for (size_t i = history - frames; i < history; i++) {
+        const double ms = historyFrame(i)._durationNs / 1e6;
+        const float height = static_cast<float>(std::min(ms / OVERLAY_GRAPH_MS, 1.0)) * GRAPH_HEIGHT;
+        const SDL_FRect bar = { x + static_cast<float>(i - (history - frames)) * barWidth, y + GRAPH_HEIGHT - height,
+                                std::max(barWidth - 1.0f, 1.0f), height };
+
+        if (ms > 1000.0 / 60.0) {
+            SDL_SetRenderDrawColor(renderer, 240, 80, 60, 255);
+        } else {
+            SDL_SetRenderDrawColor(renderer, 120, 220, 120, 255);
+        }
+        SDL_RenderFillRect(renderer, &bar);
+    }
+}
+
+bool Profiler::writeChromeTrace(const std::string &path) const {
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        SDL_Log("could not open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+
+    for (size_t i = 0; i < historySize(); i++) {
+        const FrameSample &frame = historyFrame(i);
+
+        std::fprintf(file, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+                     first ? "" : ",\n", frame._startNs / 1e3, frame._durationNs / 1e3, static_cast<unsigned long long>(frame._frame));
+        first = false;
+
+        for (int s = 0; s < frame._scopeCount; s++) {
+            const ProfileScopeSample &scope = frame._scopes[s];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                         scope._name, scope._startNs / 1e3, scope._durationNs / 1e3);
+        }
+
+        const PhysicsProfileSample &physics = frame._physics;
+        if (physics._steps > 0) {
+            std::fprintf(file, ",\n{\"name\":\"box2d ms\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":"
+                               "{\"collide\":%.4f,\"solve\":%.4f,\"pairs\":%.4f,\"refit\":%.4f,\"transforms\":%.4f,\"sleepIslands\":%.4f}}",
+                         frame._startNs / 1e3, physics._collide, physics._solve, physics._pairs, physics._refit,
+                         physics._transforms, physics._sleepIslands);
+            std::fprintf(file, ",\n{\"name\":\"box2d counters\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":"
+                               "{\"bodies\":%d,\"contacts\":%d,\"islands\":%d}}",
+                         frame._startNs / 1e3, physics._bodyCount, physics._contactCount, physics._islandCount);
+        }
+    }
+
+    std::fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    return std::fclose(file) == 0;
+}
+
+bool Profiler::writeCsv(const std::string &path) const {
+    // columns are every scope name seen in the history, first seen first
+    std::array<ScopeTotal, MAX_SCOPE_NAMES> columns{};
+    size_t columnCount = 0;
+    for (size_t i = 0; i < historySize(); i++) {
+        const FrameSample &frame = historyFrame(i);
+        for (int s = 0; s < frame._scopeCount; s++) {
+            addScopeTotal(columns, columnCount, frame._scopes[s]._name, 0);
+        }
+    }
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        SDL_Log("could not open %s for writing", path.c_str());
+        return false;
+    }
+
+    std::fprintf(file, "frame,frame_ms");
+    for (size_t c = 0; c < columnCount; c++) {
+        std::fprintf(file, ",%s_ms", columns[c]._name);
+    }
+    std::fprintf(file, ",b2_steps,b2_step_ms,b2_pairs_ms,b2_collide_ms,b2_solve_ms,b2_solve_constraints_ms,b2_transforms_ms,"
+                       "b2_refit_ms,b2_sleep_islands_ms,b2_bodies,b2_contacts,b2_islands,b2_tasks,b2_bytes,dropped_scopes\n");
+
+    std::array<ScopeTotal, MAX_SCOPE_NAMES> row{};
+    for (size_t i = 0; i < historySize(); i++) {
+        const FrameSample &frame = historyFrame(i);
+
+        size_t rowCount = columnCount;
+        for (size_t c = 0; c < columnCount; c++) {
+            row[c] = { columns[c]._name, 0 };
+        }
+        for (int s = 0; s < frame._scopeCount; s++) {
+            addScopeTotal(row, rowCount, frame._scopes[s]._name, frame._scopes[s]._durationNs);
+        }
+
+        std::fprintf(file, "%llu,%.4f", static_cast<unsigned long long>(frame._frame), frame._durationNs / 1e6);
+        for (size_t c = 0; c < columnCount; c++) {
+            std::fprintf(file, ",%.4f", row[c]._totalNs / 1e6);
+        }
+
+        const PhysicsProfileSample &physics = frame._physics;
+        std::fprintf(file, ",%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%d,%d,%d,%d,%d,%d\n",
+                     physics._steps, physics._step, physics._pairs, physics._collide, physics._solve, physics._solveConstraints,
+                     physics._transforms, physics._refit, physics._sleepIslands,
+                     physics._bodyCount, physics._contactCount, physics._islandCount, physics._taskCount, physics._byteCount,
+                     frame._droppedScopes);
+    }
+
+    return std::fclose(file) == 0;
+}
+
+bool Profiler::write(const std::string &path) const {
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+        return writeCsv(path);
+    }
+    return writeChromeTrace(path);
+}
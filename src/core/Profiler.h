@@ -0,0 +1,139 @@
+#ifndef BOUNCEPP_PROFILER_H
+#define BOUNCEPP_PROFILER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <box2d/box2d.h>
+#include <SDL3/SDL.h>
+
+// frames kept in the ring buffer, a bit over 4 seconds at 60 Hz
+constexpr int PROFILER_FRAME_HISTORY = 256;
+
+// scopes recorded per frame, further scopes in the same frame are counted but dropped
+constexpr int PROFILER_MAX_SCOPES = 64;
+
+struct ProfileScopeSample {
+    const char *_name; // string literal, never copied
+    uint64_t _startNs; // since the profiler was created
+    uint32_t _durationNs;
+    uint16_t _depth;
+};
+
+// box2d's own step breakdown, summed over every step taken in the frame (milliseconds)
+struct PhysicsProfileSample {
+    int _steps = 0;
+    float _step = 0;
+    float _pairs = 0;
+    float _collide = 0;
+    float _solve = 0;
+    float _solveConstraints = 0;
+    float _transforms = 0;
+    float _refit = 0;
+    float _sleepIslands = 0;
+
+    // counters after the last step
+    int _bodyCount = 0;
+    int _contactCount = 0;
+    int _islandCount = 0;
+    int _taskCount = 0;
+    int _byteCount = 0;
+};
+
+struct FrameSample {
+    uint64_t _frame = 0;
+    uint64_t _startNs = 0;
+    uint64_t _durationNs = 0;
+    PhysicsProfileSample _physics;
+    std::array<ProfileScopeSample, PROFILER_MAX_SCOPES> _scopes;
+    uint16_t _scopeCount = 0;
+    uint16_t _droppedScopes = 0;
+};
+
+// per-frame scoped timers and box2d profile data in a fixed ring buffer, allocation free once constructed.
+// only the thread that calls beginFrame records, scopes opened on other threads are ignored.
+// use the BOUNCEPP_PROFILE_* macros below so builds without BOUNCEPP_PROFILE compile the calls away
+class Profiler {
+
+private:
+    std::vector<FrameSample> _frames; // ring, PROFILER_FRAME_HISTORY entries
+    uint64_t _frameCount = 0;         // frames completed so far
+    FrameSample *_current = nullptr;  // frame being recorded, null between endFrame and beginFrame
+    uint16_t _depth = 0;
+
+    std::thread::id _owner;
+    const uint64_t _originNs;
+
+    bool _overlayVisible = false;
+
+    // completed frames still in the ring, index 0 is the oldest
+    size_t historySize() const;
+    const FrameSample& historyFrame(const size_t &index) const;
+
+    Profiler();
+
+public:
+    static Profiler& instance();
+
+    static uint64_t nowNs();
+
+    void beginFrame();
+    void endFrame();
+
+    // returns the scope slot to pass to endScope, -1 when nothing is recorded
+    int beginScope(const char *name);
+    void endScope(const int &slot);
+
+    // call after every b2World_Step, box2d only keeps the profile of the last step
+    void recordPhysics(const b2WorldId &worldId);
+
+    const FrameSample* getLastFrame() const;
+    uint64_t getFrameCount() const { return _frameCount; }
+
+    void toggleOverlay() { _overlayVisible = !_overlayVisible; }
+
+    // frame time graph and per-scope averages over the history, drawn with SDL's debug font
+    void drawOverlay(SDL_Renderer *renderer) const;
+
+    // chrome://tracing / Perfetto, scopes as complete events and box2d timings as counters
+    bool writeChromeTrace(const std::string &path) const;
+
+    // one row per frame, one column per scope name plus the box2d timings and counters
+    bool writeCsv(const std::string &path) const;
+
+    // picks the format from the extension, .csv or anything else for a chrome trace
+    bool write(const std::string &path) const;
+};
+
+// times the enclosing block
+class ProfileScope {
+
+private:
+    int _slot;
+
+public:
+    explicit ProfileScope(const char *name) : _slot(Profiler::instance().beginScope(name)) {}
+    ~ProfileScope() { Profiler::instance().endScope(_slot); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#ifdef BOUNCEPP_PROFILE
+#define BOUNCEPP_PROFILE_CONCAT_INNER(a, b) a##b
+#define BOUNCEPP_PROFILE_CONCAT(a, b) BOUNCEPP_PROFILE_CONCAT_INNER(a, b)
+#define BOUNCEPP_PROFILE_SCOPE(name) const ProfileScope BOUNCEPP_PROFILE_CONCAT(_profileScope, __LINE__)(name)
+#define BOUNCEPP_PROFILE_BEGIN_FRAME() Profiler::instance().beginFrame()
+#define BOUNCEPP_PROFILE_END_FRAME() Profiler::instance().endFrame()
+#define BOUNCEPP_PROFILE_PHYSICS(worldId) Profiler::instance().recordPhysics(worldId)
+#else
+#define BOUNCEPP_PROFILE_SCOPE(name) ((void)0)
+#define BOUNCEPP_PROFILE_BEGIN_FRAME() ((void)0)
+#define BOUNCEPP_PROFILE_END_FRAME() ((void)0)
+#define BOUNCEPP_PROFILE_PHYSICS(worldId) ((void)0)
+#endif
+
+#endif //BOUNCEPP_PROFILER_H
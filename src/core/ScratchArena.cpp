@@ -0,0 +1,65 @@
+#include "ScratchArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+ScratchArena::ScratchArena(const size_t capacity) {
+    if (capacity > 0) {
+        grow(capacity);
+    }
+}
+
+ScratchArena::~ScratchArena() {
+    for (const Block &block : _retired) {
+        memoryFree(block._memory);
+    }
+    memoryFree(_block._memory);
+}
+
+void ScratchArena::grow(const size_t size) {
+    // at least double, a frame that keeps growing settles after a few resets
+    const size_t capacity = std::max(size, _block._capacity * 2);
+
+    auto *memory = static_cast<std::byte*>(memoryAllocate(capacity, MEMORY_MAX_ALIGNMENT, MEMORY_SCRATCH));
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    if (_block._memory) {
+        _retired.push_back(_block);
+        _retiredUsed += _used;
+    }
+    _block = { memory, capacity };
+    _used = 0;
+}
+
+void* ScratchArena::allocateBytes(const size_t size, const size_t alignment) {
+    assert(alignment <= MEMORY_MAX_ALIGNMENT);
+
+    size_t offset = (_used + alignment - 1) / alignment * alignment;
+    if (_block._memory == nullptr || offset + size > _block._capacity) {
+        grow(size);
+        offset = 0; // blocks start MEMORY_MAX_ALIGNMENT aligned
+    }
+
+    _used = offset + size;
+    return _block._memory + offset;
+}
+
+void ScratchArena::reset() {
+    if (!_retired.empty()) {
+        // each block started aligned, leave room for the padding they did not need
+        const size_t needed = _retiredUsed + _used + MEMORY_MAX_ALIGNMENT * (_retired.size() + 1);
+        for (const Block &block : _retired) {
+            memoryFree(block._memory);
+        }
+        _retired.clear();
+        _retiredUsed = 0;
+
+        memoryFree(_block._memory);
+        _block = { nullptr, 0 };
+        grow(needed);
+    }
+    _used = 0;
+}
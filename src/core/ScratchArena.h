@@ -0,0 +1,55 @@
+#ifndef BOUNCEPP_SCRATCHARENA_H
+#define BOUNCEPP_SCRATCHARENA_H
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Memory.h"
+
+// bump allocator for buffers that only live for one tick or frame, counted under MEMORY_SCRATCH.
+// reset() drops everything at once. a frame that outgrew the block gets extra blocks, and the next reset
+// replaces them with one block big enough for all of it, so a steady workload stops allocating after a frame.
+// not thread safe, take the spans on one thread and hand them to workers
+class ScratchArena {
+
+private:
+    struct Block {
+        std::byte *_memory;
+        size_t _capacity;
+    };
+
+    Block _block = { nullptr, 0 };
+    size_t _used = 0;
+
+    std::vector<Block> _retired; // outgrown blocks of this frame, freed by reset
+    size_t _retiredUsed = 0;
+
+    void* allocateBytes(size_t size, size_t alignment);
+    void grow(size_t size);
+
+public:
+    explicit ScratchArena(size_t capacity = 0);
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // uninitialised room for count values, valid until the next reset
+    template<typename T>
+    std::span<T> allocate(const size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "scratch memory is dropped without running destructors");
+        if (count == 0) {
+            return {};
+        }
+        return { static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T))), count };
+    }
+
+    void reset();
+
+    size_t getCapacity() const { return _block._capacity; }
+    size_t getUsed() const { return _retiredUsed + _used; }
+};
+
+#endif //BOUNCEPP_SCRATCHARENA_H
@@ -0,0 +1,72 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+int SpatialGrid::cellColumn(const float &x) const {
+    return std::clamp(static_cast<int>(std::floor((x - _originX) / _cellSize)), 0, _columns - 1);
+}
+
+int SpatialGrid::cellRow(const float &y) const {
+    return std::clamp(static_cast<int>(std::floor((y - _originY) / _cellSize)), 0, _rows - 1);
+}
+
+void SpatialGrid::clear() {
+    _staged.clear();
+    _items.clear();
+    _cellStart.clear();
+    _columns = 0;
+    _rows = 0;
+    _maxItemW = 0.0f;
+    _maxItemH = 0.0f;
+}
+
+void SpatialGrid::add(const SDL_FRect &rect, const uint32_t &id) {
+    _staged.push_back({ rect, id });
+}
+
+void SpatialGrid::build() {
+    _items.clear();
+    _cellStart.clear();
+    _maxItemW = 0.0f;
+    _maxItemH = 0.0f;
+
+    if (_staged.empty()) {
+        _columns = 0;
+        _rows = 0;
+        return;
+    }
+
+    float minX = _staged[0]._rect.x, minY = _staged[0]._rect.y;
+    float maxX = minX, maxY = minY;
+    for (const auto &item : _staged) {
+        minX = std::min(minX, item._rect.x);
+        minY = std::min(minY, item._rect.y);
+        maxX = std::max(maxX, item._rect.x);
+        maxY = std::max(maxY, item._rect.y);
+        _maxItemW = std::max(_maxItemW, item._rect.w);
+        _maxItemH = std::max(_maxItemH, item._rect.h);
+    }
+
+    _originX = minX;
+    _originY = minY;
+    _columns = static_cast<int>((maxX - minX) / _cellSize) + 1;
+    _rows = static_cast<int>((maxY - minY) / _cellSize) + 1;
+
+    // counting sort of the items into their cells
+    _cellStart.assign(static_cast<size_t>(_columns) * _rows + 1, 0);
+    for (const auto &item : _staged) {
+        _cellStart[cellRow(item._rect.y) * _columns + cellColumn(item._rect.x) + 1]++;
+    }
+    for (size_t cell = 1; cell < _cellStart.size(); cell++) {
+        _cellStart[cell] += _cellStart[cell - 1];
+    }
+
+    _items.resize(_staged.size());
+    std::vector<uint32_t> cursor(_cellStart.begin(), _cellStart.end() - 1);
+    for (const auto &item : _staged) {
+        _items[cursor[cellRow(item._rect.y) * _columns + cellColumn(item._rect.x)]++] = item;
+    }
+
+    _staged.clear();
+}
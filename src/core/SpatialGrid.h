@@ -0,0 +1,74 @@
+#ifndef BOUNCEPP_SPATIALGRID_H
+#define BOUNCEPP_SPATIALGRID_H
+
+#include <cstdint>
+#include <vector>
+#include <SDL3/SDL.h>
+
+// uniform grid over axis-aligned rects that do not move, for "what is near here" queries.
+// items are bucketed by the cell of their top-left corner and stored contiguously per cell,
+// queries widen their search by the largest item so nothing is missed or reported twice.
+// build() once, then query() is read-only and safe to call from many threads.
+class SpatialGrid {
+
+private:
+    struct Item {
+        SDL_FRect _rect;
+        uint32_t _id;
+    };
+
+    float _cellSize;
+
+    std::vector<Item> _staged;
+    std::vector<Item> _items;         // sorted by cell
+    std::vector<uint32_t> _cellStart; // _items index of each cell's first item, one extra entry at the end
+
+    float _originX = 0.0f;
+    float _originY = 0.0f;
+    int _columns = 0;
+    int _rows = 0;
+    float _maxItemW = 0.0f;
+    float _maxItemH = 0.0f;
+
+    int cellColumn(const float &x) const;
+    int cellRow(const float &y) const;
+
+public:
+    explicit SpatialGrid(const float &cellSize = 256.0f) : _cellSize(cellSize) {}
+
+    void clear();
+
+    // add() stages items, build() replaces the grid contents with everything staged since the last build
+    void add(const SDL_FRect &rect, const uint32_t &id);
+    void build();
+
+    size_t size() const { return _items.size(); }
+
+    // calls callback(rect, id) for every item overlapping area
+    template<typename Callback>
+    void query(const SDL_FRect &area, Callback &&callback) const {
+        if (_items.empty()) {
+            return;
+        }
+
+        const int firstColumn = cellColumn(area.x - _maxItemW);
+        const int lastColumn = cellColumn(area.x + area.w);
+        const int firstRow = cellRow(area.y - _maxItemH);
+        const int lastRow = cellRow(area.y + area.h);
+
+        for (int row = firstRow; row <= lastRow; row++) {
+            for (int column = firstColumn; column <= lastColumn; column++) {
+                const int cell = row * _columns + column;
+                for (uint32_t i = _cellStart[cell]; i < _cellStart[cell + 1]; i++) {
+                    const SDL_FRect &rect = _items[i]._rect;
+                    if (rect.x < area.x + area.w && rect.x + rect.w > area.x &&
+                        rect.y < area.y + area.h && rect.y + rect.h > area.y) {
+                        callback(rect, _items[i]._id);
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif //BOUNCEPP_SPATIALGRID_H
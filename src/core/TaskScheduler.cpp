@@ -0,0 +1,180 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+
+// how many times an idle worker looks for work before going to sleep, box2d issues many short tasks per step
+constexpr int IDLE_SPINS = 2000;
+
+// ranges handed out per worker, a few per worker lets fast threads steal from slow ones
+constexpr int RANGES_PER_WORKER = 4;
+
+TaskScheduler::TaskScheduler(const int &workerCount)
+    : _workerCount(std::clamp(workerCount, 1, MAX_WORKERS)),
+      _queues(std::make_unique<WorkerQueue[]>(_workerCount)) {
+    _threads.reserve(_workerCount - 1);
+    for (int i = 1; i < _workerCount; i++) {
+        _threads.emplace_back(&TaskScheduler::workerLoop, this, static_cast<uint32_t>(i));
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard lock(_sleepMutex);
+        _stop.store(true, std::memory_order_release);
+    }
+    _wakeUp.notify_all();
+
+    for (auto &thread : _threads) {
+        thread.join();
+    }
+}
+
+int TaskScheduler::getDefaultWorkerCount() {
+    const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    return std::clamp(hardwareThreads, 1, MAX_WORKERS);
+}
+
+bool TaskScheduler::push(const int &queueIndex, const Range &range) {
+    WorkerQueue &queue = _queues[queueIndex];
+    std::lock_guard lock(queue._mutex);
+
+    if (queue._count == QUEUE_CAPACITY) {
+        return false;
+    }
+
+    queue._ranges[(queue._head + queue._count) % QUEUE_CAPACITY] = range;
+    queue._count++;
+    return true;
+}
+
+bool TaskScheduler::popOwn(const int &queueIndex, Range &range) {
+    WorkerQueue &queue = _queues[queueIndex];
+    std::lock_guard lock(queue._mutex);
+
+    if (queue._count == 0) {
+        return false;
+    }
+
+    queue._count--;
+    range = queue._ranges[(queue._head + queue._count) % QUEUE_CAPACITY];
+    return true;
+}
+
+bool TaskScheduler::steal(const int &thiefIndex, Range &range) {
+    for (int offset = 1; offset < _workerCount; offset++) {
+        WorkerQueue &queue = _queues[(thiefIndex + offset) % _workerCount];
+        std::lock_guard lock(queue._mutex);
+
+        if (queue._count == 0) {
+            continue;
+        }
+
+        range = queue._ranges[queue._head];
+        queue._head = (queue._head + 1) % QUEUE_CAPACITY;
+        queue._count--;
+        return true;
+    }
+
+    return false;
+}
+
+bool TaskScheduler::tryRunOne(const uint32_t &workerIndex) {
+    Range range{};
+    if (!popOwn(static_cast<int>(workerIndex), range) && !steal(static_cast<int>(workerIndex), range)) {
+        return false;
+    }
+
+    _pendingRanges.fetch_sub(1, std::memory_order_relaxed);
+    range._task->_function(range._start, range._end, workerIndex, range._task->_context);
+    range._task->_remainingRanges.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+void TaskScheduler::workerLoop(const uint32_t workerIndex) {
+    while (!_stop.load(std::memory_order_acquire)) {
+        bool ranWork = false;
+        for (int spin = 0; spin < IDLE_SPINS && !ranWork; spin++) {
+            ranWork = tryRunOne(workerIndex);
+            if (!ranWork && _pendingRanges.load(std::memory_order_relaxed) == 0) {
+                std::this_thread::yield();
+            }
+        }
+
+        if (ranWork) {
+            continue;
+        }
+
+        std::unique_lock lock(_sleepMutex);
+        _wakeUp.wait(lock, [this] {
+            return _stop.load(std::memory_order_acquire) || _pendingRanges.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void* TaskScheduler::enqueue(TaskFunction *function, const int &itemCount, const int &minRange, void *context) {
+    if (itemCount <= 0) {
+        return nullptr;
+    }
+
+    const int rangeCount = std::clamp(itemCount / std::max(minRange, 1), 1, _workerCount * RANGES_PER_WORKER);
+
+    // no other workers, or out of task slots: run it right here.
+    // single range tasks are still queued, box2d's solver relies on its worker tasks running concurrently
+    if (_workerCount == 1 || _taskCount == MAX_TASKS) {
+        function(0, itemCount, 0, context);
+        return nullptr;
+    }
+
+    Task &task = _tasks[_taskCount++];
+    _openTasks++;
+    task._function = function;
+    task._context = context;
+    task._remainingRanges.store(rangeCount, std::memory_order_relaxed);
+
+    // deal the ranges out round robin so every worker starts with something local
+    const int rangeSize = itemCount / rangeCount;
+    const int remainder = itemCount % rangeCount;
+    int start = 0;
+    int queued = 0;
+
+    for (int i = 0; i < rangeCount; i++) {
+        const int end = start + rangeSize + (i < remainder ? 1 : 0);
+        const Range range{ &task, start, end };
+
+        if (push(_nextQueue, range)) {
+            queued++;
+        } else {
+            // queue full, do it now rather than drop it
+            function(start, end, 0, context);
+            task._remainingRanges.fetch_sub(1, std::memory_order_release);
+        }
+
+        _nextQueue = (_nextQueue + 1) % _workerCount;
+        start = end;
+    }
+
+    if (queued > 0) {
+        {
+            std::lock_guard lock(_sleepMutex);
+            _pendingRanges.fetch_add(queued, std::memory_order_release);
+        }
+        _wakeUp.notify_all();
+    }
+
+    return &task;
+}
+
+void TaskScheduler::finish(void *task) {
+    auto *waitingOn = static_cast<Task*>(task);
+
+    while (waitingOn->_remainingRanges.load(std::memory_order_acquire) > 0) {
+        if (!tryRunOne(0)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // every task handed out since the last reset is done, slots can be reused
+    if (--_openTasks == 0) {
+        _taskCount = 0;
+    }
+}
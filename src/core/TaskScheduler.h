@@ -0,0 +1,101 @@
+#ifndef BOUNCEPP_TASKSCHEDULER_H
+#define BOUNCEPP_TASKSCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// work-stealing thread pool for data-parallel ranges.
+// the thread that owns the scheduler is worker 0 and is the only one allowed to enqueue and finish tasks,
+// it works through queued ranges while it waits. the other workers each own a range queue and steal from
+// the rest when theirs runs dry.
+class TaskScheduler {
+
+public:
+    // same shape as box2d's b2TaskCallback so world tasks can be queued without an adapter
+    using TaskFunction = void(int startIndex, int endIndex, uint32_t workerIndex, void *context);
+
+    static constexpr int MAX_WORKERS = 64;
+    static constexpr int MAX_TASKS = 256; // tasks in flight between two points where all of them are finished
+
+private:
+    struct Task {
+        TaskFunction *_function = nullptr;
+        void *_context = nullptr;
+        std::atomic<int> _remainingRanges{0};
+    };
+
+    struct Range {
+        Task *_task;
+        int _start;
+        int _end;
+    };
+
+    static constexpr int QUEUE_CAPACITY = 1024;
+
+    // fixed size ring buffer; the owning worker pops from the back, thieves take from the front
+    struct alignas(64) WorkerQueue {
+        std::mutex _mutex;
+        Range _ranges[QUEUE_CAPACITY];
+        int _head = 0;
+        int _count = 0;
+    };
+
+    int _workerCount;
+    std::vector<std::thread> _threads;
+    std::unique_ptr<WorkerQueue[]> _queues;
+
+    Task _tasks[MAX_TASKS];
+    int _taskCount = 0;  // owner thread only
+    int _openTasks = 0;  // owner thread only
+    int _nextQueue = 0;  // owner thread only
+
+    std::atomic<int> _pendingRanges{0};
+    std::atomic<bool> _stop{false};
+    std::mutex _sleepMutex;
+    std::condition_variable _wakeUp;
+
+    bool push(const int &queueIndex, const Range &range);
+    bool popOwn(const int &queueIndex, Range &range);
+    bool steal(const int &thiefIndex, Range &range);
+    bool tryRunOne(const uint32_t &workerIndex);
+
+    void workerLoop(uint32_t workerIndex);
+
+public:
+    // workerCount includes the owning thread, 1 means everything runs inline with no extra threads
+    explicit TaskScheduler(const int &workerCount);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    static int getDefaultWorkerCount();
+
+    int getWorkerCount() const { return _workerCount; }
+
+    // splits [0, itemCount) into ranges of at least minRange items.
+    // returns nullptr when the work already ran inline, otherwise a handle that must be passed to finish()
+    void* enqueue(TaskFunction *function, const int &itemCount, const int &minRange, void *context);
+
+    // blocks until the task is done, running queued ranges on the calling thread in the meantime
+    void finish(void *task);
+
+    // runs function(start, end, workerIndex) over [0, itemCount) and returns once every range is done
+    template<typename Function>
+    void parallelFor(const int &itemCount, const int &minRange, Function &function) {
+        auto trampoline = [](const int startIndex, const int endIndex, const uint32_t workerIndex, void *context) {
+            (*static_cast<Function*>(context))(startIndex, endIndex, workerIndex);
+        };
+
+        if (void *task = enqueue(trampoline, itemCount, minRange, &function)) {
+            finish(task);
+        }
+    }
+};
+
+#endif //BOUNCEPP_TASKSCHEDULER_H
@@ -0,0 +1,45 @@
+#ifndef BOUNCEPP_TRIPLEBUFFER_H
+#define BOUNCEPP_TRIPLEBUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// hands the newest value from exactly one writer thread to exactly one reader thread without locks.
+// the writer fills back() and publishes it, the reader takes the newest published slot with acquire().
+// neither side ever waits: the writer overwrites values the reader skipped, the reader keeps the last
+// value while nothing new arrived. slots are reused, so their heap capacity carries over
+template<typename T>
+class TripleBuffer {
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4; // the middle slot holds a value the reader has not taken yet
+
+    std::array<T, 3> _slots{};
+
+    alignas(64) std::atomic<uint8_t> _middle{1};
+    alignas(64) uint8_t _back = 0;  // writer only
+    alignas(64) uint8_t _front = 2; // reader only
+
+public:
+    T& back() { return _slots[_back]; }
+
+    // makes back() visible to the reader and hands the writer another slot
+    void publish() {
+        _back = _middle.exchange(static_cast<uint8_t>(_back | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // switches front() to the newest published value, false if nothing was published since the last call
+    bool acquire() {
+        if ((_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return _slots[_front]; }
+};
+
+#endif //BOUNCEPP_TRIPLEBUFFER_H
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <concepts>
+#include <tuple>
+
+#include "components.hpp"
+
+namespace components {
+    // surface and mass of an archetype's shape, density 0 for bodies that never move
+    struct Material {
+        float _density;
+        float _friction;
+        float _restitution;
+    };
+
+    // one descriptor per entity type. everything that differs between types is a constexpr member,
+    // so the factory and the systems are instantiated per archetype instead of branching on EntityType
+    struct BallArchetype {
+        static constexpr EntityType TYPE = EntityType::BALL;
+        static constexpr const char *NAME = "ball";
+
+        static constexpr int WIDTH = 25;
+        static constexpr int HEIGHT = 25;
+
+        static constexpr b2BodyType BODY_TYPE = b2_dynamicBody;
+        static constexpr Material MATERIAL = { 40.0f, 1.2f, 0.25f };
+        static constexpr bool ROTATES = true;
+        static constexpr bool REPORTS_CONTACTS = true; // touch and hit events for the ContactDispatcher
+
+        static constexpr const char *TEXTURE = "ball_image.png"; // nullptr draws a solid COLOR instead
+        static constexpr int TEXTURE_SIZE = 64; // decoded at most this big, leaves room to zoom in
+        static constexpr SDL_Color COLOR = { 255, 255, 255, SDL_ALPHA_OPAQUE };
+    };
+
+    struct PlatformArchetype {
+        static constexpr EntityType TYPE = EntityType::PLATFORM;
+        static constexpr const char *NAME = "platform";
+
+        static constexpr int WIDTH = 200;
+        static constexpr int HEIGHT = 10;
+
+        static constexpr b2BodyType BODY_TYPE = b2_staticBody;
+        static constexpr Material MATERIAL = { 0.0f, 0.6f, 0.0f };
+        static constexpr bool ROTATES = false;
+        static constexpr bool REPORTS_CONTACTS = false;
+
+        static constexpr const char *TEXTURE = nullptr;
+        static constexpr int TEXTURE_SIZE = 0;
+        static constexpr SDL_Color COLOR = { 166, 44, 8, SDL_ALPHA_OPAQUE }; // dark brown
+    };
+
+    template<typename A>
+    concept Archetype = requires {
+        { A::TYPE } -> std::convertible_to<EntityType>;
+        { A::NAME } -> std::convertible_to<const char*>;
+        { A::WIDTH } -> std::convertible_to<int>;
+        { A::HEIGHT } -> std::convertible_to<int>;
+        { A::BODY_TYPE } -> std::convertible_to<b2BodyType>;
+        { A::MATERIAL } -> std::convertible_to<Material>;
+        { A::ROTATES } -> std::convertible_to<bool>;
+        { A::REPORTS_CONTACTS } -> std::convertible_to<bool>;
+        { A::TEXTURE } -> std::convertible_to<const char*>;
+        { A::TEXTURE_SIZE } -> std::convertible_to<int>;
+        { A::COLOR } -> std::convertible_to<SDL_Color>;
+    };
+
+    // every entity carries the tag of its archetype, views over it visit that type only
+    template<Archetype A>
+    struct ArchetypeTag {};
+
+    using BallTag = ArchetypeTag<BallArchetype>;
+    using PlatformTag = ArchetypeTag<PlatformArchetype>;
+
+    // every archetype, in EntityType order. a new entity type is a descriptor, an EntityType and an entry here
+    using Archetypes = std::tuple<BallArchetype, PlatformArchetype>;
+
+    static_assert(std::tuple_size_v<Archetypes> == ENTITY_TYPE_COUNT);
+    static_assert(std::tuple_element_t<EntityType::BALL, Archetypes>::TYPE == EntityType::BALL);
+    static_assert(std::tuple_element_t<EntityType::PLATFORM, Archetypes>::TYPE == EntityType::PLATFORM);
+
+    // calls function(archetype) with a value of each descriptor type, use decltype(archetype) to get at it
+    template<typename Function>
+    constexpr void forEachArchetype(Function &&function) {
+        std::apply([&](auto... archetypes) { (function(archetypes), ...); }, Archetypes{});
+    }
+}
+
+// archetype tag pools are counted under MEMORY_ECS like the pools in components.hpp, for every archetype at once
+namespace entt {
+    template<components::Archetype A>
+    struct storage_type<components::ArchetypeTag<A>, entity, std::allocator<components::ArchetypeTag<A>>> {
+        using type = sigh_mixin<basic_storage<components::ArchetypeTag<A>, entity, TrackedAllocator<components::ArchetypeTag<A>>>, registry>;
+    };
+}
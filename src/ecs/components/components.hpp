@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstdint>
+
 #include <box2d/box2d.h>
+#include <entt/entt.hpp>
 #include <SDL3/SDL.h>
 
+#include "../../core/Memory.h"
+
 namespace components {
     static constexpr float PPM = 50.0f; // 50 pixels = 1 meter
     inline float px_to_m(const float px) { return px / PPM; }
@@ -13,6 +18,8 @@ namespace components {
         PLATFORM = 1
     };
 
+    static constexpr int ENTITY_TYPE_COUNT = 2;
+
     enum ControlledBy {
         MANUAL = 0,
         AI = 1,
@@ -28,21 +35,88 @@ namespace components {
         EMPTY_COMMAND = 4
     };
 
-    struct PhysicsData {
-        b2BodyDef _bodyDef;
-        b2ShapeDef _shapeDef;
-        b2Polygon _polygon;
-        b2BodyId _physicsBodyId;
+    // index into the AssetManager's sprite table, 0 is never a valid sprite
+    using SpriteHandle = uint32_t;
+    static constexpr SpriteHandle NO_SPRITE = 0;
+
+    // hot per-tick handle to the box2d body, the body and shape definitions are only needed at creation
+    // and are not kept; query box2d (b2Body_GetType, b2Body_GetShapes, ...) if they are ever needed again
+    struct PhysicsBody {
+        b2BodyId _bodyId;
     };
 
     struct RenderingData {
         mutable SDL_FRect _rect{};
         mutable double _rotDeg = 0;
+
+        // transform before the last physics step, rendering blends towards _rect/_rotDeg
+        mutable SDL_FPoint _prevPos{};
+        mutable double _prevRotDeg = 0;
+
+        mutable SpriteHandle _sprite = NO_SPRITE;
+    };
+
+    // controller tags, mirror MetaData::_controlledBy so each input source iterates only its own entities
+    struct ManualControlled {};
+    struct AiControlled {};
+
+    // driven by the remote client with this id, ids are handed out in ball creation order
+    struct NetworkControlled {
+        uint16_t _clientId;
+    };
+
+    // number of platforms a ball is currently touching, maintained from box2d contact events
+    struct GroundContact {
+        mutable int _contacts = 0;
+        mutable float _lastImpactSpeed = 0.0f; // approach speed of the last hard landing, m/s
     };
 
+    // marks entities whose body never moves, the renderer caches them in a static layer
+    struct StaticTag {};
+
+    // what the window shows: _center is the world pixel at the middle of the viewport, one world pixel
+    // covers _zoom screen pixels. the render system keeps _viewport in sync with the output size
+    struct Camera {
+        mutable SDL_FPoint _center{};
+        mutable float _zoom = 1.0f;
+        mutable SDL_FPoint _viewport{};
+        float _followRate = 6.0f; // fraction of the distance to the target closed per second, roughly
+    };
+
+    // the camera follows the first entity with this tag
+    struct CameraTarget {};
+
+    // despawned into a BallPool: the body is disabled and out of the broadphase, and every system skips the entity
+    struct Parked {};
+
     struct MetaData {
         EntityType _entityType;
         mutable ControlledBy _controlledBy = ControlledBy::NOT_CONTROLLED;
         mutable Command _currentCommand = Command::EMPTY_COMMAND;
     };
-}
\ No newline at end of file
+}
+
+// every component pool allocates through the memory subsystem and is counted under MEMORY_ECS, the archetype
+// tags are registered in archetypes.hpp. the storage keeps the sigh mixin so on_construct / on_destroy still work.
+// the registry's own entity storage keeps std::allocator and is not counted, see MemoryBudget
+#define BOUNCEPP_TRACKED_STORAGE(Type) \
+    template<> \
+    struct storage_type<Type, entity, std::allocator<Type>> { \
+        using type = sigh_mixin<basic_storage<Type, entity, TrackedAllocator<Type>>, registry>; \
+    };
+
+namespace entt {
+    BOUNCEPP_TRACKED_STORAGE(components::PhysicsBody)
+    BOUNCEPP_TRACKED_STORAGE(components::RenderingData)
+    BOUNCEPP_TRACKED_STORAGE(components::ManualControlled)
+    BOUNCEPP_TRACKED_STORAGE(components::AiControlled)
+    BOUNCEPP_TRACKED_STORAGE(components::NetworkControlled)
+    BOUNCEPP_TRACKED_STORAGE(components::GroundContact)
+    BOUNCEPP_TRACKED_STORAGE(components::StaticTag)
+    BOUNCEPP_TRACKED_STORAGE(components::Camera)
+    BOUNCEPP_TRACKED_STORAGE(components::CameraTarget)
+    BOUNCEPP_TRACKED_STORAGE(components::Parked)
+    BOUNCEPP_TRACKED_STORAGE(components::MetaData)
+}
+
+#undef BOUNCEPP_TRACKED_STORAGE
@@ -0,0 +1,125 @@
+#include "BallPool.h"
+
+#include <algorithm>
+
+BallPool::BallPool(Factory &factory, const ControlledBy &controlledBy, const size_t &maxParked)
+    : _factory(factory), _controlledBy(controlledBy), _maxParked(maxParked) {
+    _parked.reserve(maxParked);
+    _cooling.reserve(maxParked);
+}
+
+void BallPool::park(entt::registry &registry, const entt::entity &ball, std::vector<entt::entity> &into) {
+    const b2BodyId bodyId = registry.get<PhysicsBody>(ball)._bodyId;
+    b2Body_SetLinearVelocity(bodyId, {0.0f, 0.0f});
+    b2Body_SetAngularVelocity(bodyId, 0.0f);
+    b2Body_Disable(bodyId); // out of the broadphase, so it is neither simulated nor drawn
+
+    // contact events still pending for it are skipped by the dispatcher while it is Parked
+    registry.get<MetaData>(ball)._currentCommand = Command::EMPTY_COMMAND;
+    registry.emplace<Parked>(ball);
+
+    into.push_back(ball);
+}
+
+void BallPool::unpark(entt::registry &registry, const entt::entity &ball, const int &x, const int &y) const {
+    registry.remove<Parked>(ball);
+
+    // its contacts went with the broadphase proxy. reset here rather than in park, begin events of the
+    // step before parking may still have been dispatched to it. its end-touch events were skipped while cooling
+    registry.get<GroundContact>(ball)._contacts = 0;
+
+    // same reset as GameLogic::resetPosition, applied while the body is still out of the world
+    const b2BodyId bodyId = registry.get<PhysicsBody>(ball)._bodyId;
+    const b2Vec2 center = {
+        px_to_m(static_cast<float>(x) + BALL_WIDTH / 2.0f),
+        px_to_m(static_cast<float>(y) + BALL_HEIGHT / 2.0f)
+    };
+    b2Body_SetTransform(bodyId, center, b2MakeRot(0.0f));
+    b2Body_Enable(bodyId);
+    b2Body_SetAwake(bodyId, true);
+
+    // no interpolation from where it was parked
+    const auto &renderingData = registry.get<RenderingData>(ball);
+    renderingData._rect.x = static_cast<float>(x);
+    renderingData._rect.y = static_cast<float>(y);
+    renderingData._prevPos = { renderingData._rect.x, renderingData._rect.y };
+    renderingData._rotDeg = 0.0;
+    renderingData._prevRotDeg = 0.0;
+}
+
+void BallPool::reserve(entt::registry &registry, const size_t &count) {
+    const size_t room = _maxParked - std::min(_parked.size() + _cooling.size(), _maxParked);
+    const size_t created = std::min(count, room);
+
+    // stacked on one spot, they are disabled before the world ever steps them, so they touched nothing
+    // and can be reused right away
+    std::vector<entt::entity> balls;
+    balls.reserve(created);
+    const std::vector<SDL_Point> positions(created, SDL_Point{0, 0});
+    _factory.createBalls(registry, positions, balls, _controlledBy);
+
+    for (const auto ball : balls) {
+        park(registry, ball, _parked);
+    }
+    _stats.parked = _parked.size() + _cooling.size();
+}
+
+entt::entity BallPool::spawn(entt::registry &registry, const int &x, const int &y) {
+    entt::entity ball;
+    if (!_parked.empty()) {
+        ball = _parked.back();
+        _parked.pop_back();
+        unpark(registry, ball, x, y);
+        _stats.reuses++;
+    } else {
+        ball = _factory.createBall(registry, x, y, _controlledBy);
+    }
+
+    _stats.spawns++;
+    _stats.active++;
+    _stats.peakActive = std::max(_stats.peakActive, _stats.active);
+    _stats.parked = _parked.size() + _cooling.size();
+    return ball;
+}
+
+void BallPool::despawn(entt::registry &registry, const entt::entity &ball) {
+    if (!registry.valid(ball) || registry.all_of<Parked>(ball)) {
+        return;
+    }
+
+    const auto *metaData = registry.try_get<MetaData>(ball);
+    const bool pooled = registry.all_of<BallTag>(ball) && metaData && metaData->_controlledBy == _controlledBy;
+    if (!pooled) {
+        _factory.destroyEntity(registry, ball);
+        return;
+    }
+
+    if (_parked.size() + _cooling.size() < _maxParked) {
+        park(registry, ball, _cooling);
+    } else {
+        _factory.destroyEntity(registry, ball);
+        _stats.overflows++;
+    }
+
+    _stats.despawns++;
+    _stats.active -= std::min<size_t>(_stats.active, 1);
+    _stats.parked = _parked.size() + _cooling.size();
+}
+
+void BallPool::onStep() {
+    // no allocation, both together never hold more than maxParked
+    _parked.insert(_parked.end(), _cooling.begin(), _cooling.end());
+    _cooling.clear();
+}
+
+void BallPool::clear(entt::registry &registry) {
+    for (const auto ball : _parked) {
+        _factory.destroyEntity(registry, ball);
+    }
+    for (const auto ball : _cooling) {
+        _factory.destroyEntity(registry, ball);
+    }
+    _parked.clear();
+    _cooling.clear();
+    _stats.parked = 0;
+}
@@ -0,0 +1,68 @@
+#ifndef BOUNCEPP_BALLPOOL_H
+#define BOUNCEPP_BALLPOOL_H
+
+#include <cstdint>
+#include <vector>
+#include <entt/entt.hpp>
+
+#include "factory.h"
+
+struct BallPoolStats {
+    size_t active = 0; // spawned through the pool and not despawned yet
+    size_t parked = 0;
+    size_t peakActive = 0;
+
+    uint64_t spawns = 0;
+    uint64_t reuses = 0; // spawns served by a parked ball
+    uint64_t despawns = 0;
+    uint64_t overflows = 0; // despawns that destroyed the ball because the pool was full
+
+    double reuseRate() const { return spawns > 0 ? static_cast<double>(reuses) / static_cast<double>(spawns) : 0.0; }
+};
+
+// recycles balls for spawners that churn through them. a despawned ball is parked: its body is disabled
+// and it is tagged Parked, so it keeps its entity, body and shape. spawning takes a parked ball back
+// before creating a new one, so once the pool is warm, spawning and despawning allocate nothing.
+// disabling a body queues end-touch events that box2d only reports after the next step, so a ball parked
+// since the last step cools until onStep and is not handed out before its stale events were skipped.
+// parked balls belong to the registry and world they were created in, clear the pool before resetting either
+class BallPool {
+
+private:
+    Factory &_factory;
+    ControlledBy _controlledBy;
+    size_t _maxParked;
+
+    std::vector<entt::entity> _parked; // most recently parked last, reused first while its memory is warm
+    std::vector<entt::entity> _cooling; // parked since the last step, their end-touch events are still pending
+    BallPoolStats _stats;
+
+    void park(entt::registry &registry, const entt::entity &ball, std::vector<entt::entity> &into);
+    void unpark(entt::registry &registry, const entt::entity &ball, const int &x, const int &y) const;
+
+public:
+    // every ball of the pool is controlled the same way, despawns beyond maxParked destroy the ball
+    explicit BallPool(Factory &factory, const ControlledBy &controlledBy = ControlledBy::NOT_CONTROLLED, const size_t &maxParked = 4096);
+
+    BallPool(const BallPool&) = delete;
+    BallPool& operator=(const BallPool&) = delete;
+
+    // creates parked balls up front, so even the first spawns skip body creation
+    void reserve(entt::registry &registry, const size_t &count);
+
+    // a ball at rest with its top-left corner at x, y
+    entt::entity spawn(entt::registry &registry, const int &x, const int &y);
+
+    // parks a ball spawned by this pool, other entities are destroyed through the factory
+    void despawn(entt::registry &registry, const entt::entity &ball);
+
+    // call once per step, after its contact events were dispatched. balls parked before it become reusable
+    void onStep();
+
+    // destroys every parked ball
+    void clear(entt::registry &registry);
+
+    const BallPoolStats& getStats() const { return _stats; }
+};
+
+#endif //BOUNCEPP_BALLPOOL_H
@@ -6,43 +6,22 @@
 
 // private
 
-PhysicsData Factory::createPhysicsData(const float x, const float y, const float w, const float h, const b2WorldId worldId, const entt::entity entity, const bool isDynamic) {
-    auto data = PhysicsData();
+PhysicsBody Factory::createPhysicsBody(b2BodyDef &bodyDef, b2ShapeDef &shapeDef, const b2Polygon &polygon, const b2WorldId worldId, const entt::entity entity) {
+    bodyDef.userData = reinterpret_cast<void*>(entity);
+    shapeDef.userData = reinterpret_cast<void*>(entity); // contact events resolve straight to the entity
 
-    const float center_x_m = px_to_m(x + w / 2.0f);
-    const float center_y_m = px_to_m(y + h / 2.0f);
-
-    data._bodyDef = b2DefaultBodyDef();
-
-    if (isDynamic) {
-        data._bodyDef.type = b2_dynamicBody;
-    }
-
-    data._bodyDef.position = { center_x_m, center_y_m };
-    data._bodyDef.userData = reinterpret_cast<void*>(entity);
-    data._physicsBodyId = b2CreateBody(worldId, &data._bodyDef);
-
-    data._shapeDef = b2DefaultShapeDef();
-
-    if (isDynamic) {
-        data._shapeDef.density = 40.0f;
-        data._shapeDef.material.friction = 1.2f;
-        data._shapeDef.material.restitution = 0.25f;
-        data._shapeDef.enableContactEvents = true;
-    } else {
-        data._shapeDef.density = 0.0f;
-    }
-
-    data._polygon = b2MakeBox(px_to_m(w / 2.0f), px_to_m(h / 2.0f));
-
-    b2CreatePolygonShape(data._physicsBodyId, &data._shapeDef, &data._polygon);
+    auto data = PhysicsBody();
+    data._bodyId = b2CreateBody(worldId, &bodyDef);
+    b2CreatePolygonShape(data._bodyId, &shapeDef, &polygon);
 
     return data;
 }
 
-RenderingData Factory::createRenderingData(const float x, const float y, const float w, const float h) {
+RenderingData Factory::createRenderingData(const float x, const float y, const float w, const float h, EntityType entityType) {
     auto data = RenderingData();
     data._rect = { x, y, w, h };
+    data._prevPos = { x, y };
+    data._sprite = static_cast<size_t>(entityType) < _sprites.size() ? _sprites[entityType] : NO_SPRITE;
     return data;
 }
 
@@ -53,23 +32,116 @@ MetaData Factory::createMetaData(EntityType entityType, ControlledBy controlled_
     return data;
 }
 
+void Factory::emplaceController(entt::registry &registry, const entt::entity &entity, const ControlledBy controlledBy) {
+    switch (controlledBy) {
+        case ControlledBy::MANUAL:
+            registry.emplace<ManualControlled>(entity);
+            break;
+        case ControlledBy::AI:
+            registry.emplace<AiControlled>(entity);
+            break;
+        case ControlledBy::NETWORK:
+            registry.emplace<NetworkControlled>(entity, _nextNetworkClientId++);
+            break;
+        default: ;
+    }
+}
+
+void Factory::insertControllers(entt::registry &registry, const std::span<const entt::entity> entities, const ControlledBy controlledBy) {
+    switch (controlledBy) {
+        case ControlledBy::MANUAL:
+            registry.insert<ManualControlled>(entities.begin(), entities.end());
+            break;
+        case ControlledBy::AI:
+            registry.insert<AiControlled>(entities.begin(), entities.end());
+            break;
+        case ControlledBy::NETWORK:
+            for (const auto entity : entities) {
+                registry.emplace<NetworkControlled>(entity, _nextNetworkClientId++);
+            }
+            break;
+        default: ;
+    }
+}
+
 // public
 
-const entt::entity& Factory::createBall(entt::registry &registry, const int &x, const int &y) {
-    const auto ball = registry.create();
-    registry.emplace<PhysicsData>(ball, createPhysicsData(x, y, BALL_WIDTH, BALL_HEIGHT, _worldId, ball, true));
-    registry.emplace<RenderingData>(ball, createRenderingData(x, y, BALL_WIDTH, BALL_HEIGHT));
+entt::entity Factory::createBall(entt::registry &registry, const int &x, const int &y, const ControlledBy &controlledBy) {
+    return create<BallArchetype>(registry, x, y, controlledBy);
+}
 
-    ControlledBy controlledBy = ControlledBy::MANUAL;
-    registry.emplace<MetaData>(ball, createMetaData(EntityType::BALL, controlledBy));
+entt::entity Factory::createStep(entt::registry &registry, const int &x, const int &y) {
+    return create<PlatformArchetype>(registry, x, y);
+}
+
+void Factory::createBalls(entt::registry &registry, const std::span<const SDL_Point> positions, std::vector<entt::entity> &entities,
+                          const ControlledBy &controlledBy) {
+    createMany<BallArchetype>(registry, positions, entities, controlledBy);
+}
+
+void Factory::createSteps(entt::registry &registry, const std::span<const SDL_Point> positions, std::vector<entt::entity> &entities) {
+    createMany<PlatformArchetype>(registry, positions, entities);
+}
+
+entt::entity Factory::createCamera(entt::registry &registry, const entt::entity &target, const float &zoom) {
+    Camera camera;
+    camera._zoom = zoom;
+
+    if (registry.valid(target)) {
+        const SDL_FRect &rect = registry.get<RenderingData>(target)._rect;
+        camera._center = { rect.x + rect.w / 2.0f, rect.y + rect.h / 2.0f };
+        registry.emplace_or_replace<CameraTarget>(target);
+    }
 
-    return ball;
+    const auto entity = registry.create();
+    registry.emplace<Camera>(entity, camera);
+    return entity;
 }
 
-const entt::entity& Factory::createStep(entt::registry &registry, const int &x, const int &y) {
-    const auto step = registry.create();
-    registry.emplace<PhysicsData>(step, createPhysicsData(x, y, PLATFORM_WIDTH, PLATFORM_HEIGHT, _worldId, step));
-    registry.emplace<RenderingData>(step, createRenderingData(x, y, PLATFORM_WIDTH, PLATFORM_HEIGHT));
-    registry.emplace<MetaData>(step, createMetaData(EntityType::PLATFORM, ControlledBy::NOT_CONTROLLED));
-    return step;
-}
\ No newline at end of file
+void Factory::destroyEntity(entt::registry &registry, const entt::entity &entity) {
+    if (!registry.valid(entity)) {
+        return;
+    }
+
+    if (const auto *physicsBody = registry.try_get<PhysicsBody>(entity)) {
+        if (registry.all_of<PlatformTag>(entity)) {
+            _contacts.resize(b2Body_GetContactCapacity(physicsBody->_bodyId));
+            const int count = b2Body_GetContactData(physicsBody->_bodyId, _contacts.data(), static_cast<int>(_contacts.size()));
+
+            // every touching contact had its begin event dispatched and counted, see the header
+            for (int i = 0; i < count; i++) {
+                const b2ContactData &contact = _contacts[i];
+                if (contact.manifold.pointCount == 0) {
+                    continue;
+                }
+
+                // whichever shape is not ours belongs to what was touching the platform
+                auto other = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(b2Shape_GetUserData(contact.shapeIdA)));
+                if (other == entity) {
+                    other = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(b2Shape_GetUserData(contact.shapeIdB)));
+                }
+
+                if (const auto *groundContact = registry.try_get<GroundContact>(other); groundContact && groundContact->_contacts > 0) {
+                    groundContact->_contacts--;
+                }
+            }
+        }
+
+        b2DestroyBody(physicsBody->_bodyId);
+    }
+
+    registry.destroy(entity);
+}
+
+entt::entity Factory::restoreEntity(entt::registry &registry, const entt::entity &hint, const EntityType &entityType,
+                                    const ControlledBy &controlledBy, const SDL_FRect &rect, const double &rotDeg, const BodyState &bodyState) {
+    // the saved type is only known at runtime, this is the one place it is turned back into an archetype
+    entt::entity entity = entt::null;
+    forEachArchetype([&](auto archetype) {
+        using A = decltype(archetype);
+        if (A::TYPE == entityType) {
+            entity = restore<A>(registry, hint, controlledBy, rect, rotDeg, bodyState);
+        }
+    });
+    return entity;
+}
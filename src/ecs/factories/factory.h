@@ -5,36 +5,257 @@
 #ifndef BOUNCEPP_FACTORY_H
 #define BOUNCEPP_FACTORY_H
 
+#include <span>
+#include <vector>
 #include <entt/entt.hpp>
+#include "../components/archetypes.hpp"
 #include "../components/components.hpp"
 
 using namespace components;
 
-constexpr int BALL_WIDTH = 25;
-constexpr int BALL_HEIGHT = 25;
+constexpr int BALL_WIDTH = BallArchetype::WIDTH;
+constexpr int BALL_HEIGHT = BallArchetype::HEIGHT;
 
-constexpr int PLATFORM_WIDTH = 200;
-constexpr int PLATFORM_HEIGHT = 10;
+constexpr int PLATFORM_WIDTH = PlatformArchetype::WIDTH;
+constexpr int PLATFORM_HEIGHT = PlatformArchetype::HEIGHT;
+
+// full state of a body, lets a saved world be recreated in place instead of created and then moved
+struct BodyState {
+    b2Vec2 position;
+    b2Rot rotation;
+    b2Vec2 linearVelocity;
+    float angularVelocity;
+    bool awake;
+};
 
 class Factory {
 
 private:
-    std::vector<SDL_Texture*> _textures;
+    std::vector<SpriteHandle> _sprites; // indexed by EntityType, missing entries draw nothing
 
     b2WorldId _worldId;
 
-    PhysicsData createPhysicsData(const float x, const float y, const float w, const float h, const b2WorldId worldId, const entt::entity entity, const bool isDynamic = false);
+    uint16_t _nextNetworkClientId = 0;
+
+    // reused by destroyEntity
+    std::vector<b2ContactData> _contacts;
+
+    // reused by the batch creators
+    std::vector<PhysicsBody> _batchBodies;
+    std::vector<RenderingData> _batchRenderingData;
+
+    // userData of both definitions is set to the entity, everything else is used as given
+    static PhysicsBody createPhysicsBody(b2BodyDef &bodyDef, b2ShapeDef &shapeDef, const b2Polygon &polygon, const b2WorldId worldId, const entt::entity entity);
+
+    template<Archetype A>
+    static b2BodyDef createBodyDef();
+
+    template<Archetype A>
+    static b2ShapeDef createShapeDef();
 
-    RenderingData createRenderingData(const float x, const float y, const float w, const float h);
+    template<Archetype A>
+    static b2Polygon createPolygon();
+
+    RenderingData createRenderingData(const float x, const float y, const float w, const float h, EntityType entityType);
 
     MetaData createMetaData(EntityType entityType, ControlledBy controlled_by);
 
+    void emplaceController(entt::registry &registry, const entt::entity &entity, ControlledBy controlledBy);
+
+    void insertControllers(entt::registry &registry, std::span<const entt::entity> entities, ControlledBy controlledBy);
+
+    // the components that come with the archetype rather than with every entity
+    template<Archetype A>
+    static void emplaceArchetypeComponents(entt::registry &registry, const entt::entity &entity);
+
+    template<Archetype A>
+    entt::entity restore(entt::registry &registry, const entt::entity &hint, const ControlledBy &controlledBy,
+                         const SDL_FRect &rect, const double &rotDeg, const BodyState &bodyState);
+
 public:
-    explicit Factory(const std::vector<SDL_Texture*> &textures, const b2WorldId &worldId) : _textures(textures), _worldId(worldId) {};
+    explicit Factory(const std::vector<SpriteHandle> &sprites, const b2WorldId &worldId) : _sprites(sprites), _worldId(worldId) {};
+
+    // an entity of archetype A with its top-left corner at x, y
+    template<Archetype A>
+    entt::entity create(entt::registry &registry, const int &x, const int &y, const ControlledBy &controlledBy = ControlledBy::NOT_CONTROLLED);
 
-    const entt::entity& createBall(entt::registry &registry, const int &x, const int &y);
+    // batch version of create for spawning thousands at once: pools are reserved once, the box2d definitions
+    // are built once and shared, and components are inserted per range. the new entities are appended to `entities`
+    template<Archetype A>
+    void createMany(entt::registry &registry, std::span<const SDL_Point> positions, std::vector<entt::entity> &entities,
+                    const ControlledBy &controlledBy = ControlledBy::NOT_CONTROLLED);
 
-    const entt::entity& createStep(entt::registry &registry, const int &x, const int &y);
+    entt::entity createBall(entt::registry &registry, const int &x, const int &y, const ControlledBy &controlledBy = ControlledBy::MANUAL);
+
+    entt::entity createStep(entt::registry &registry, const int &x, const int &y);
+
+    // batch versions of createBall and createStep, see createMany
+    void createBalls(entt::registry &registry, std::span<const SDL_Point> positions, std::vector<entt::entity> &entities,
+                     const ControlledBy &controlledBy = ControlledBy::MANUAL);
+
+    void createSteps(entt::registry &registry, std::span<const SDL_Point> positions, std::vector<entt::entity> &entities);
+
+    // a camera entity that starts centred on `target` and follows it, see CameraSystem
+    entt::entity createCamera(entt::registry &registry, const entt::entity &target, const float &zoom = 1.0f);
+
+    // destroys the body and the entity. balls resting on a destroyed platform have that contact released,
+    // box2d's end-touch events for it arrive with an invalid shape and are skipped by the dispatcher.
+    // only release-safe between ContactDispatcher::dispatch and the next step: a platform's touching contacts
+    // then are exactly the ones whose begin events were counted. a contact begun in a step whose events are
+    // still pending would be released without ever having been counted
+    void destroyEntity(entt::registry &registry, const entt::entity &entity);
+
+    // recreates a saved entity of any archetype, keeping its entity id when it is free. see WorldSnapshot
+    entt::entity restoreEntity(entt::registry &registry, const entt::entity &hint, const EntityType &entityType,
+                               const ControlledBy &controlledBy, const SDL_FRect &rect, const double &rotDeg, const BodyState &bodyState);
 };
 
+// archetype templates, instantiated per descriptor so no entity type is looked up at runtime
+
+template<Archetype A>
+b2BodyDef Factory::createBodyDef() {
+    // definitions are only needed to build the body, the component keeps just the id
+    b2BodyDef bodyDef = b2DefaultBodyDef();
+    bodyDef.type = A::BODY_TYPE;
+
+    // static bodies never rotate, only moving archetypes need the lock
+    if constexpr (!A::ROTATES && A::BODY_TYPE != b2_staticBody) {
+        bodyDef.fixedRotation = true;
+    }
+    return bodyDef;
+}
+
+template<Archetype A>
+b2ShapeDef Factory::createShapeDef() {
+    b2ShapeDef shapeDef = b2DefaultShapeDef();
+    shapeDef.density = A::MATERIAL._density;
+    shapeDef.material.friction = A::MATERIAL._friction;
+    shapeDef.material.restitution = A::MATERIAL._restitution;
+
+    if constexpr (A::REPORTS_CONTACTS) {
+        shapeDef.enableContactEvents = true;
+        shapeDef.enableHitEvents = true;
+    }
+    return shapeDef;
+}
+
+template<Archetype A>
+b2Polygon Factory::createPolygon() {
+    return b2MakeBox(px_to_m(A::WIDTH / 2.0f), px_to_m(A::HEIGHT / 2.0f));
+}
+
+template<Archetype A>
+void Factory::emplaceArchetypeComponents(entt::registry &registry, const entt::entity &entity) {
+    registry.emplace<ArchetypeTag<A>>(entity);
+
+    if constexpr (A::BODY_TYPE == b2_staticBody) {
+        registry.emplace<StaticTag>(entity);
+    } else {
+        registry.emplace<GroundContact>(entity);
+    }
+}
+
+template<Archetype A>
+entt::entity Factory::create(entt::registry &registry, const int &x, const int &y, const ControlledBy &controlledBy) {
+    constexpr float w = A::WIDTH;
+    constexpr float h = A::HEIGHT;
+    const auto fx = static_cast<float>(x);
+    const auto fy = static_cast<float>(y);
+
+    const auto entity = registry.create();
+
+    b2BodyDef bodyDef = createBodyDef<A>();
+    bodyDef.position = { px_to_m(fx + w / 2.0f), px_to_m(fy + h / 2.0f) };
+    b2ShapeDef shapeDef = createShapeDef<A>();
+    registry.emplace<PhysicsBody>(entity, createPhysicsBody(bodyDef, shapeDef, createPolygon<A>(), _worldId, entity));
+
+    registry.emplace<RenderingData>(entity, createRenderingData(fx, fy, w, h, A::TYPE));
+    registry.emplace<MetaData>(entity, createMetaData(A::TYPE, controlledBy));
+    emplaceArchetypeComponents<A>(registry, entity);
+    emplaceController(registry, entity, controlledBy);
+
+    return entity;
+}
+
+template<Archetype A>
+void Factory::createMany(entt::registry &registry, const std::span<const SDL_Point> positions, std::vector<entt::entity> &entities,
+                         const ControlledBy &controlledBy) {
+    constexpr float w = A::WIDTH;
+    constexpr float h = A::HEIGHT;
+
+    const size_t count = positions.size();
+    const size_t first = entities.size();
+    entities.resize(first + count);
+
+    const auto begin = entities.begin() + static_cast<std::ptrdiff_t>(first);
+    const auto end = entities.end();
+
+    // every pool grows at most once for the whole batch
+    auto &entityStorage = registry.storage<entt::entity>();
+    entityStorage.reserve(entityStorage.size() + count);
+    registry.storage<PhysicsBody>().reserve(registry.storage<PhysicsBody>().size() + count);
+    registry.storage<RenderingData>().reserve(registry.storage<RenderingData>().size() + count);
+    registry.storage<MetaData>().reserve(registry.storage<MetaData>().size() + count);
+
+    registry.create(begin, end);
+
+    // one set of definitions for the batch, only position and user data change per body
+    b2BodyDef bodyDef = createBodyDef<A>();
+    b2ShapeDef shapeDef = createShapeDef<A>();
+    const b2Polygon polygon = createPolygon<A>();
+
+    _batchBodies.resize(count);
+    _batchRenderingData.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        const auto x = static_cast<float>(positions[i].x);
+        const auto y = static_cast<float>(positions[i].y);
+
+        bodyDef.position = { px_to_m(x + w / 2.0f), px_to_m(y + h / 2.0f) };
+        _batchBodies[i] = createPhysicsBody(bodyDef, shapeDef, polygon, _worldId, entities[first + i]);
+        _batchRenderingData[i] = createRenderingData(x, y, w, h, A::TYPE);
+    }
+
+    registry.insert<PhysicsBody>(begin, end, _batchBodies.begin());
+    registry.insert<RenderingData>(begin, end, _batchRenderingData.begin());
+    registry.insert<MetaData>(begin, end, createMetaData(A::TYPE, controlledBy));
+    registry.insert<ArchetypeTag<A>>(begin, end);
+
+    if constexpr (A::BODY_TYPE == b2_staticBody) {
+        registry.insert<StaticTag>(begin, end);
+    } else {
+        registry.insert<GroundContact>(begin, end);
+    }
+
+    insertControllers(registry, { entities.data() + first, count }, controlledBy);
+}
+
+template<Archetype A>
+entt::entity Factory::restore(entt::registry &registry, const entt::entity &hint, const ControlledBy &controlledBy,
+                              const SDL_FRect &rect, const double &rotDeg, const BodyState &bodyState) {
+    const auto entity = registry.create(hint);
+
+    // the body starts out where it was saved, so box2d never has to move it in the broadphase
+    b2BodyDef bodyDef = createBodyDef<A>();
+    bodyDef.position = bodyState.position;
+    bodyDef.rotation = bodyState.rotation;
+    bodyDef.linearVelocity = bodyState.linearVelocity;
+    bodyDef.angularVelocity = bodyState.angularVelocity;
+    bodyDef.isAwake = bodyState.awake;
+
+    b2ShapeDef shapeDef = createShapeDef<A>();
+    const b2Polygon polygon = b2MakeBox(px_to_m(rect.w / 2.0f), px_to_m(rect.h / 2.0f));
+    registry.emplace<PhysicsBody>(entity, createPhysicsBody(bodyDef, shapeDef, polygon, _worldId, entity));
+
+    RenderingData &renderingData = registry.emplace<RenderingData>(entity, createRenderingData(rect.x, rect.y, rect.w, rect.h, A::TYPE));
+    renderingData._rotDeg = rotDeg;
+    renderingData._prevRotDeg = rotDeg;
+
+    registry.emplace<MetaData>(entity, createMetaData(A::TYPE, controlledBy));
+    emplaceArchetypeComponents<A>(registry, entity);
+    emplaceController(registry, entity, controlledBy);
+
+    return entity;
+}
+
 #endif //BOUNCEPP_FACTORY_H
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "AiSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+// how far around a ball it looks for platforms, pixels
+constexpr float SEARCH_HALF_WIDTH = 300.0f;
+constexpr float SEARCH_ABOVE = 150.0f;
+constexpr float SEARCH_BELOW = 40.0f;
+
+// a platform top this far above the ball centre can be reached with one jump, pixels
+constexpr float MIN_CLIMB = 20.0f;
+constexpr float MAX_CLIMB = 130.0f;
+
+// jump once the ball is this close (horizontally) to the platform it wants to climb, pixels
+constexpr float JUMP_DISTANCE = 40.0f;
+
+// stop pushing once the ball already moves this fast in the wanted direction, meters per second
+constexpr float MAX_PUSH_SPEED = 4.0f;
+
+AiSystem::AiSystem(entt::registry &registry, TaskScheduler &taskScheduler)
+    : _registry(registry), _taskScheduler(taskScheduler) {
+    _registry.on_construct<StaticTag>().connect<&AiSystem::markPlatformGridDirty>(*this);
+    _registry.on_destroy<StaticTag>().connect<&AiSystem::markPlatformGridDirty>(*this);
+}
+
+AiSystem::~AiSystem() {
+    _registry.on_construct<StaticTag>().disconnect(this);
+    _registry.on_destroy<StaticTag>().disconnect(this);
+}
+
+void AiSystem::markPlatformGridDirty(entt::registry &, entt::entity) {
+    _platformGridDirty = true;
+}
+
+void AiSystem::rebuildPlatformGrid() {
+    _platformGrid.clear();
+    for (auto [entity, renderData] : _registry.view<StaticTag, RenderingData>().each()) {
+        _platformGrid.add(renderData._rect, entt::to_integral(entity));
+    }
+    _platformGrid.build();
+    _platformGridDirty = false;
+}
+
+void AiSystem::gather() {
+    _entities.clear();
+    _posX.clear();
+    _posY.clear();
+    _velX.clear();
+    _velY.clear();
+    _grounded.clear();
+
+    for (auto [entity, physicsBody, groundContact] : _registry.view<AiControlled, PhysicsBody, GroundContact>(entt::exclude<Parked>).each()) {
+        const b2Vec2 position = b2Body_GetPosition(physicsBody._bodyId);
+        const b2Vec2 velocity = b2Body_GetLinearVelocity(physicsBody._bodyId);
+
+        _entities.push_back(entity);
+        _posX.push_back(m_to_px(position.x));
+        _posY.push_back(m_to_px(position.y));
+        _velX.push_back(velocity.x);
+        _velY.push_back(velocity.y);
+        _grounded.push_back(groundContact._contacts > 0 ? 1 : 0);
+    }
+
+    _commands.resize(_entities.size());
+}
+
+void AiSystem::decide(const int start, const int end) {
+    for (int i = start; i < end; i++) {
+        const float x = _posX[i];
+        const float y = _posY[i];
+        // resting on a platform and not already on the way up
+        const bool grounded = _grounded[i] != 0 && _velY[i] > -0.5f;
+
+        // pick the reachable platform above that needs the least horizontal travel
+        bool hasTarget = false;
+        float targetDx = 0.0f;
+
+        const SDL_FRect area = { x - SEARCH_HALF_WIDTH, y - SEARCH_ABOVE, SEARCH_HALF_WIDTH * 2.0f, SEARCH_ABOVE + SEARCH_BELOW };
+        _platformGrid.query(area, [&](const SDL_FRect &platform, uint32_t) {
+            const float climb = y - platform.y;
+            if (climb < MIN_CLIMB || climb > MAX_CLIMB) {
+                return;
+            }
+
+            const float dx = std::clamp(x, platform.x, platform.x + platform.w) - x;
+            if (!hasTarget || std::fabs(dx) < std::fabs(targetDx)) {
+                hasTarget = true;
+                targetDx = dx;
+            }
+        });
+
+        Command command = Command::EMPTY_COMMAND;
+
+        if (hasTarget) {
+            if (grounded && std::fabs(targetDx) < JUMP_DISTANCE) {
+                command = Command::JUMP;
+            } else if (targetDx < 0.0f) {
+                command = Command::MOVE_LEFT;
+            } else if (targetDx > 0.0f) {
+                command = Command::MOVE_RIGHT;
+            }
+        } else if (grounded && std::fabs(_velX[i]) < 0.2f) {
+            // nothing to climb and stuck, hop to get going again
+            command = Command::JUMP;
+        } else {
+            // keep rolling the way we are going
+            command = _velX[i] < 0.0f ? Command::MOVE_LEFT : Command::MOVE_RIGHT;
+        }
+
+        // do not keep accelerating a ball that is already fast enough
+        if ((command == Command::MOVE_LEFT && _velX[i] < -MAX_PUSH_SPEED) ||
+            (command == Command::MOVE_RIGHT && _velX[i] > MAX_PUSH_SPEED)) {
+            command = Command::EMPTY_COMMAND;
+        }
+
+        _commands[i] = command;
+    }
+}
+
+void AiSystem::scatter() const {
+    const auto &metaStorage = _registry.storage<MetaData>();
+    for (size_t i = 0; i < _entities.size(); i++) {
+        if (_commands[i] != Command::EMPTY_COMMAND) {
+            metaStorage.get(_entities[i])._currentCommand = _commands[i];
+        }
+    }
+}
+
+void AiSystem::processAi() {
+    if (_platformGridDirty) {
+        rebuildPlatformGrid();
+    }
+
+    gather();
+    if (_entities.empty()) {
+        return;
+    }
+
+    auto kernel = [this](const int start, const int end, uint32_t) {
+        decide(start, end);
+    };
+    _taskScheduler.parallelFor(static_cast<int>(_entities.size()), AI_CHUNK_SIZE, kernel);
+
+    scatter();
+}
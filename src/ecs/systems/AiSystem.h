@@ -0,0 +1,58 @@
+#ifndef BOUNCEPP_AISYSTEM_H
+#define BOUNCEPP_AISYSTEM_H
+
+#include <cstdint>
+#include <vector>
+#include <entt/entt.hpp>
+
+#include "../components/components.hpp"
+#include "../../core/SpatialGrid.h"
+#include "../../core/TaskScheduler.h"
+
+using namespace components;
+
+// AI balls handed to one worker at a time, large enough to amortise the task overhead
+constexpr int AI_CHUNK_SIZE = 256;
+
+// decides a Command for every AiControlled ball each tick.
+// ball state is gathered into flat arrays, the decision kernel runs over chunks of them on the task
+// scheduler against a grid of nearby platforms, and the results are written back to MetaData.
+class AiSystem {
+
+private:
+    entt::registry &_registry;
+    TaskScheduler &_taskScheduler;
+
+    // static platform rects, rebuilt when StaticTag entities come or go
+    SpatialGrid _platformGrid;
+    bool _platformGridDirty = true;
+
+    // structure of arrays for the kernel, reused between ticks
+    std::vector<entt::entity> _entities;
+    std::vector<float> _posX; // pixels, ball centre
+    std::vector<float> _posY;
+    std::vector<float> _velX; // meters per second
+    std::vector<float> _velY;
+    std::vector<uint8_t> _grounded;
+    std::vector<Command> _commands;
+
+    void markPlatformGridDirty(entt::registry &registry, entt::entity entity);
+    void rebuildPlatformGrid();
+
+    void gather();
+    void decide(int start, int end);
+    void scatter() const;
+
+public:
+    explicit AiSystem(entt::registry &registry, TaskScheduler &taskScheduler);
+    ~AiSystem();
+
+    AiSystem(const AiSystem&) = delete;
+    AiSystem& operator=(const AiSystem&) = delete;
+
+    void processAi();
+
+    size_t getAiCount() const { return _entities.size(); }
+};
+
+#endif //BOUNCEPP_AISYSTEM_H
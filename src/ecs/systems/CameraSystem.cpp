@@ -0,0 +1,52 @@
+#include "CameraSystem.h"
+
+#include <cmath>
+
+void CameraSystem::update(const entt::registry &registry, const float &frameSeconds, const float &alpha) const {
+    const auto targets = registry.view<CameraTarget, RenderingData>(entt::exclude<Parked>);
+    if (targets.begin() == targets.end()) {
+        return;
+    }
+
+    // follow what is drawn, not the last physics state, or the target jitters against the background
+    const RenderingData &renderData = targets.get<RenderingData>(*targets.begin());
+    const SDL_FPoint target = {
+        renderData._prevPos.x + (renderData._rect.x - renderData._prevPos.x) * alpha + renderData._rect.w / 2.0f,
+        renderData._prevPos.y + (renderData._rect.y - renderData._prevPos.y) * alpha + renderData._rect.h / 2.0f
+    };
+
+    for (auto [entity, camera] : registry.view<Camera>().each()) {
+        follow(camera, target, frameSeconds);
+    }
+}
+
+void CameraSystem::follow(const Camera &camera, const SDL_FPoint &target, const float &frameSeconds) {
+    const float blend = 1.0f - std::exp(-camera._followRate * frameSeconds);
+    camera._center.x += (target.x - camera._center.x) * blend;
+    camera._center.y += (target.y - camera._center.y) * blend;
+}
+
+SDL_FRect CameraSystem::getVisibleArea(const Camera &camera) {
+    const float w = camera._viewport.x / camera._zoom;
+    const float h = camera._viewport.y / camera._zoom;
+    return { camera._center.x - w / 2.0f, camera._center.y - h / 2.0f, w, h };
+}
+
+SDL_FPoint CameraSystem::worldToScreen(const Camera &camera, const SDL_FPoint &world) {
+    return {
+        (world.x - camera._center.x) * camera._zoom + camera._viewport.x / 2.0f,
+        (world.y - camera._center.y) * camera._zoom + camera._viewport.y / 2.0f
+    };
+}
+
+SDL_FRect CameraSystem::worldToScreen(const Camera &camera, const SDL_FRect &world) {
+    const SDL_FPoint topLeft = worldToScreen(camera, SDL_FPoint{ world.x, world.y });
+    return { topLeft.x, topLeft.y, world.w * camera._zoom, world.h * camera._zoom };
+}
+
+SDL_FPoint CameraSystem::screenToWorld(const Camera &camera, const SDL_FPoint &screen) {
+    return {
+        (screen.x - camera._viewport.x / 2.0f) / camera._zoom + camera._center.x,
+        (screen.y - camera._viewport.y / 2.0f) / camera._zoom + camera._center.y
+    };
+}
@@ -0,0 +1,29 @@
+#ifndef BOUNCEPP_CAMERASYSTEM_H
+#define BOUNCEPP_CAMERASYSTEM_H
+
+#include <entt/entt.hpp>
+#include <SDL3/SDL.h>
+
+#include "../components/components.hpp"
+
+using namespace components;
+
+// moves the Camera towards its CameraTarget and converts between world and screen pixels
+class CameraSystem {
+
+public:
+    // frame rate independent follow of the target's interpolated position, call once per rendered frame
+    void update(const entt::registry &registry, const float &frameSeconds, const float &alpha) const;
+
+    // eases camera towards target (world pixels), for cameras that live outside the registry
+    static void follow(const Camera &camera, const SDL_FPoint &target, const float &frameSeconds);
+
+    // world rectangle the camera shows
+    static SDL_FRect getVisibleArea(const Camera &camera);
+
+    static SDL_FPoint worldToScreen(const Camera &camera, const SDL_FPoint &world);
+    static SDL_FRect worldToScreen(const Camera &camera, const SDL_FRect &world);
+    static SDL_FPoint screenToWorld(const Camera &camera, const SDL_FPoint &screen);
+};
+
+#endif //BOUNCEPP_CAMERASYSTEM_H
@@ -0,0 +1,96 @@
+#include "ContactDispatcher.h"
+
+static entt::entity entityOf(const b2ShapeId &shapeId) {
+    return static_cast<entt::entity>(reinterpret_cast<uintptr_t>(b2Shape_GetUserData(shapeId)));
+}
+
+// false when either shape or entity is gone since the step or the entity was parked, their events are skipped
+template<typename MetaStorage, typename ParkedStorage>
+static bool resolvePair(const b2ShapeId &shapeIdA, const b2ShapeId &shapeIdB, const MetaStorage &metaStorage,
+                        const ParkedStorage *parkedStorage, entt::entity &eA, entt::entity &eB) {
+    if (!b2Shape_IsValid(shapeIdA) || !b2Shape_IsValid(shapeIdB)) {
+        return false;
+    }
+
+    eA = entityOf(shapeIdA);
+    eB = entityOf(shapeIdB);
+    if (!metaStorage.contains(eA) || !metaStorage.contains(eB)) {
+        return false;
+    }
+    return parkedStorage == nullptr || (!parkedStorage->contains(eA) && !parkedStorage->contains(eB));
+}
+
+template<typename Handler>
+void ContactDispatcher::registerHandler(HandlerTable<Handler> &table, const EntityType first, const EntityType second, Handler handler) {
+    table[first][second] = { handler, false };
+    if (first != second) {
+        table[second][first] = { handler, true };
+    }
+}
+
+void ContactDispatcher::onBegin(const EntityType first, const EntityType second, const ContactHandler handler) {
+    registerHandler(_beginHandlers, first, second, handler);
+}
+
+void ContactDispatcher::onEnd(const EntityType first, const EntityType second, const ContactHandler handler) {
+    registerHandler(_endHandlers, first, second, handler);
+}
+
+void ContactDispatcher::onHit(const EntityType first, const EntityType second, const HitHandler handler) {
+    registerHandler(_hitHandlers, first, second, handler);
+}
+
+void ContactDispatcher::dispatch(const b2WorldId &worldId, const entt::registry &registry) const {
+    const auto *metaStorage = registry.storage<MetaData>();
+    if (metaStorage == nullptr) {
+        return;
+    }
+    const auto *parkedStorage = registry.storage<Parked>(); // null until the first ball is parked
+
+    const b2ContactEvents contactEvents = b2World_GetContactEvents(worldId);
+
+    // begin events
+    for (int i = 0; i < contactEvents.beginCount; i++) {
+        const b2ContactBeginTouchEvent &ev = contactEvents.beginEvents[i];
+
+        entt::entity eA, eB;
+        if (!resolvePair(ev.shapeIdA, ev.shapeIdB, *metaStorage, parkedStorage, eA, eB)) {
+            continue;
+        }
+
+        const auto &slot = _beginHandlers[metaStorage->get(eA)._entityType][metaStorage->get(eB)._entityType];
+        if (slot._handler != nullptr) {
+            slot._swapped ? slot._handler(registry, eB, eA) : slot._handler(registry, eA, eB);
+        }
+    }
+
+    // end events
+    for (int i = 0; i < contactEvents.endCount; i++) {
+        const b2ContactEndTouchEvent &ev = contactEvents.endEvents[i];
+
+        entt::entity eA, eB;
+        if (!resolvePair(ev.shapeIdA, ev.shapeIdB, *metaStorage, parkedStorage, eA, eB)) {
+            continue;
+        }
+
+        const auto &slot = _endHandlers[metaStorage->get(eA)._entityType][metaStorage->get(eB)._entityType];
+        if (slot._handler != nullptr) {
+            slot._swapped ? slot._handler(registry, eB, eA) : slot._handler(registry, eA, eB);
+        }
+    }
+
+    // hit events, only for shapes with enableHitEvents and above the world's hit speed threshold
+    for (int i = 0; i < contactEvents.hitCount; i++) {
+        const b2ContactHitEvent &ev = contactEvents.hitEvents[i];
+
+        entt::entity eA, eB;
+        if (!resolvePair(ev.shapeIdA, ev.shapeIdB, *metaStorage, parkedStorage, eA, eB)) {
+            continue;
+        }
+
+        const auto &slot = _hitHandlers[metaStorage->get(eA)._entityType][metaStorage->get(eB)._entityType];
+        if (slot._handler != nullptr) {
+            slot._swapped ? slot._handler(registry, eB, eA, ev.approachSpeed) : slot._handler(registry, eA, eB, ev.approachSpeed);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef BOUNCEPP_CONTACTDISPATCHER_H
+#define BOUNCEPP_CONTACTDISPATCHER_H
+
+#include <array>
+#include <box2d/box2d.h>
+#include <entt/entt.hpp>
+
+#include "../components/archetypes.hpp"
+#include "../components/components.hpp"
+
+using namespace components;
+
+// handlers get the two entities in the order they were registered in, not the order box2d reported them
+using ContactHandler = void (*)(const entt::registry &registry, entt::entity first, entt::entity second);
+using HitHandler = void (*)(const entt::registry &registry, entt::entity first, entt::entity second, float approachSpeed);
+
+// routes box2d contact events to handlers looked up by the EntityType pair of the two shapes.
+// shapes carry their entity as user data, so each event costs two shape lookups, two MetaData reads
+// and one table lookup. nothing is allocated while dispatching.
+class ContactDispatcher {
+
+private:
+    template<typename Handler>
+    struct Slot {
+        Handler _handler = nullptr;
+        bool _swapped = false; // registered as (second, first), swap the entities back before calling
+    };
+
+    template<typename Handler>
+    using HandlerTable = std::array<std::array<Slot<Handler>, ENTITY_TYPE_COUNT>, ENTITY_TYPE_COUNT>;
+
+    HandlerTable<ContactHandler> _beginHandlers{};
+    HandlerTable<ContactHandler> _endHandlers{};
+    HandlerTable<HitHandler> _hitHandlers{};
+
+    template<typename Handler>
+    static void registerHandler(HandlerTable<Handler> &table, EntityType first, EntityType second, Handler handler);
+
+public:
+    void onBegin(EntityType first, EntityType second, ContactHandler handler);
+    void onEnd(EntityType first, EntityType second, ContactHandler handler);
+    void onHit(EntityType first, EntityType second, HitHandler handler);
+
+    // same, with the pair named by archetype
+    template<Archetype First, Archetype Second>
+    void onBegin(ContactHandler handler) { onBegin(First::TYPE, Second::TYPE, handler); }
+
+    template<Archetype First, Archetype Second>
+    void onEnd(ContactHandler handler) { onEnd(First::TYPE, Second::TYPE, handler); }
+
+    template<Archetype First, Archetype Second>
+    void onHit(HitHandler handler) { onHit(First::TYPE, Second::TYPE, handler); }
+
+    // reads the contact events of the last step and calls the matching handlers.
+    // events naming a shape or entity destroyed since the step, or a Parked entity, are skipped
+    void dispatch(const b2WorldId &worldId, const entt::registry &registry) const;
+};
+
+#endif //BOUNCEPP_CONTACTDISPATCHER_H
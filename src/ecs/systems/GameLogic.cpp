@@ -6,73 +6,78 @@
 
 #include "../factories/factory.h"
 
-void GameLogic::processPlatformCollision(bool isBeginCollision) {
-    if (isBeginCollision) {
-        allowJump = true;
-    } else {
-        allowJump = false;
-    }
+// contact handlers
+
+void GameLogic::onBallTouchPlatform(const entt::registry &registry, const entt::entity ball, entt::entity) {
+    registry.get<GroundContact>(ball)._contacts++;
 }
 
-void GameLogic::processBeginCollision(const MetaData &metaA, const MetaData &metaB) {
-    if ((metaA._entityType == EntityType::BALL && metaB._entityType == EntityType::PLATFORM) ||
-        (metaB._entityType == EntityType::BALL && metaA._entityType == EntityType::PLATFORM)) {
-        processPlatformCollision(true);
+void GameLogic::onBallLeavePlatform(const entt::registry &registry, const entt::entity ball, entt::entity) {
+    const auto &groundContact = registry.get<GroundContact>(ball);
+    if (groundContact._contacts > 0) {
+        groundContact._contacts--;
     }
 }
 
-void GameLogic::processEndCollision(const MetaData &metaA, const MetaData &metaB) {
-    if ((metaA._entityType == EntityType::BALL && metaB._entityType == EntityType::PLATFORM) ||
-        (metaB._entityType == EntityType::BALL && metaA._entityType == EntityType::PLATFORM)) {
-        processPlatformCollision(false);
-    }
+void GameLogic::onBallHitPlatform(const entt::registry &registry, const entt::entity ball, entt::entity, const float approachSpeed) {
+    registry.get<GroundContact>(ball)._lastImpactSpeed = approachSpeed;
+}
+
+GameLogic::GameLogic() {
+    _contactDispatcher.onBegin<BallArchetype, PlatformArchetype>(&GameLogic::onBallTouchPlatform);
+    _contactDispatcher.onEnd<BallArchetype, PlatformArchetype>(&GameLogic::onBallLeavePlatform);
+    _contactDispatcher.onHit<BallArchetype, PlatformArchetype>(&GameLogic::onBallHitPlatform);
 }
 
-void GameLogic::jump(const PhysicsData &physicsData) const {
-    if (allowJump) {
+// actions
+
+void GameLogic::jump(const PhysicsBody &physicsBody, const GroundContact *groundContact) const {
+    // only balls standing on something can jump
+    if (groundContact != nullptr && groundContact->_contacts > 0) {
         constexpr b2Vec2 impulse = {0.0f, -80.0f};
-        b2Body_ApplyLinearImpulseToCenter(physicsData._physicsBodyId, impulse, true);
+        b2Body_ApplyLinearImpulseToCenter(physicsBody._bodyId, impulse, true);
     }
 }
 
-void GameLogic::moveLeft(const PhysicsData &physicsData) const {
+void GameLogic::moveLeft(const PhysicsBody &physicsBody) const {
     constexpr b2Vec2 impulse = {-25.0f, 0.0f};
-    b2Body_ApplyLinearImpulseToCenter(physicsData._physicsBodyId, impulse, true);
+    b2Body_ApplyLinearImpulseToCenter(physicsBody._bodyId, impulse, true);
 }
 
-void GameLogic::moveRight(const PhysicsData &physicsData) const {
+void GameLogic::moveRight(const PhysicsBody &physicsBody) const {
     constexpr b2Vec2 impulse = {25.0f, 0.0f};
-    b2Body_ApplyLinearImpulseToCenter(physicsData._physicsBodyId, impulse, true);
+    b2Body_ApplyLinearImpulseToCenter(physicsBody._bodyId, impulse, true);
 }
 
-void GameLogic::resetPosition(const PhysicsData &physicsData, const float x, const float y, const float w, const float h) const {
+void GameLogic::resetPosition(const PhysicsBody &physicsBody, const float x, const float y, const float w, const float h) const {
     const b2Vec2 center = {
         px_to_m(x + w / 2.0f),
         px_to_m(y + h / 2.0f)
     };
 
-    b2Body_SetTransform(physicsData._physicsBodyId, center, b2MakeRot(0.0f));
-    b2Body_SetLinearVelocity(physicsData._physicsBodyId, {0.0f, 0.0f});
-    b2Body_SetAngularVelocity(physicsData._physicsBodyId, 0.0f);
-    b2Body_SetAwake(physicsData._physicsBodyId, true);
+    b2Body_SetTransform(physicsBody._bodyId, center, b2MakeRot(0.0f));
+    b2Body_SetLinearVelocity(physicsBody._bodyId, {0.0f, 0.0f});
+    b2Body_SetAngularVelocity(physicsBody._bodyId, 0.0f);
+    b2Body_SetAwake(physicsBody._bodyId, true);
 }
 
 
 void GameLogic::applyInputActions(const entt::registry &registry) const {
-    auto view = registry.view<PhysicsData, MetaData>();
-    for (auto [entity, physicsData, metaData] : view.each()) {
+    // only balls take commands, the view never touches the (possibly millions of) platforms
+    auto view = registry.view<BallTag, PhysicsBody, MetaData>(entt::exclude<Parked>);
+    for (auto [entity, physicsBody, metaData] : view.each()) {
         switch (metaData._currentCommand) {
             case Command::JUMP:
-                jump(physicsData);
+                jump(physicsBody, registry.try_get<GroundContact>(entity));
                 break;
             case Command::MOVE_LEFT:
-                moveLeft(physicsData);
+                moveLeft(physicsBody);
                 break;
             case Command::MOVE_RIGHT:
-                moveRight(physicsData);
+                moveRight(physicsBody);
                 break;
             case Command::RESET_POSITION:
-                resetPosition(physicsData, 500.0f, 400.0f, BALL_WIDTH, BALL_HEIGHT);
+                resetPosition(physicsBody, 500.0f, 400.0f, BALL_WIDTH, BALL_HEIGHT);
                 break;
         }
 
@@ -80,44 +85,6 @@ void GameLogic::applyInputActions(const entt::registry &registry) const {
     }
 }
 
-void GameLogic::checkPhysicsEvents(const b2WorldId &worldId, const entt::registry &registry) {
-    const b2ContactEvents contactEvents = b2World_GetContactEvents(worldId);
-
-    // begin events
-    for (int i = 0; i < contactEvents.beginCount; i++) {
-        const b2ContactBeginTouchEvent& ev = contactEvents.beginEvents[i];
-
-        const b2ShapeId shapeA = ev.shapeIdA;
-        const b2ShapeId shapeB = ev.shapeIdB;
-
-        b2BodyId bodyA = b2Shape_GetBody(shapeA);
-        b2BodyId bodyB = b2Shape_GetBody(shapeB);
-
-        entt::entity eA = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(b2Body_GetUserData(bodyA)));
-        entt::entity eB = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(b2Body_GetUserData(bodyB)));
-
-        auto dataA = registry.get<MetaData>(eA);
-        auto dataB = registry.get<MetaData>(eB);
-
-        processBeginCollision(dataA, dataB);
-    }
-
-    // end events
-    for (int i = 0; i < contactEvents.endCount; i++) {
-        const b2ContactEndTouchEvent& ev = contactEvents.endEvents[i];
-
-        const b2ShapeId shapeA = ev.shapeIdA;
-        const b2ShapeId shapeB = ev.shapeIdB;
-
-        b2BodyId bodyA = b2Shape_GetBody(shapeA);
-        b2BodyId bodyB = b2Shape_GetBody(shapeB);
-
-        entt::entity eA = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(b2Body_GetUserData(bodyA)));
-        entt::entity eB = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(b2Body_GetUserData(bodyB)));
-
-        auto dataA = registry.get<MetaData>(eA);
-        auto dataB = registry.get<MetaData>(eB);
-
-        processEndCollision(dataA, dataB);
-    }
+void GameLogic::checkPhysicsEvents(const b2WorldId &worldId, const entt::registry &registry) const {
+    _contactDispatcher.dispatch(worldId, registry);
 }
@@ -8,6 +8,7 @@
 #include<box2d/box2d.h>
 #include<entt/entt.hpp>
 
+#include "ContactDispatcher.h"
 #include "../components/components.hpp"
 
 using namespace components;
@@ -15,22 +16,24 @@ using namespace components;
 class GameLogic {
 
 private:
-    bool allowJump = false;
+    ContactDispatcher _contactDispatcher;
 
-    // collision logic functions
-    void processPlatformCollision(bool isBeginCollision);
-    void processBeginCollision(const MetaData &metaA, const MetaData &metaB);
-    void processEndCollision(const MetaData &metaA, const MetaData &metaB);
+    // collision logic functions, registered with the contact dispatcher per EntityType pair
+    static void onBallTouchPlatform(const entt::registry &registry, entt::entity ball, entt::entity platform);
+    static void onBallLeavePlatform(const entt::registry &registry, entt::entity ball, entt::entity platform);
+    static void onBallHitPlatform(const entt::registry &registry, entt::entity ball, entt::entity platform, float approachSpeed);
 
     // action functions
-    void jump(const PhysicsData &physicsData) const;
-    void moveLeft(const PhysicsData &physicsData) const;
-    void moveRight(const PhysicsData &physicsData) const;
-    void resetPosition(const PhysicsData &physicsData, const float x, const float y, const float w, const float h) const;
+    void jump(const PhysicsBody &physicsBody, const GroundContact *groundContact) const;
+    void moveLeft(const PhysicsBody &physicsBody) const;
+    void moveRight(const PhysicsBody &physicsBody) const;
+    void resetPosition(const PhysicsBody &physicsBody, const float x, const float y, const float w, const float h) const;
 
 public:
+    GameLogic();
+
     void applyInputActions(const entt::registry &registry) const;
-    void checkPhysicsEvents(const b2WorldId &worldId, const entt::registry &registry);
+    void checkPhysicsEvents(const b2WorldId &worldId, const entt::registry &registry) const;
 };
 
 
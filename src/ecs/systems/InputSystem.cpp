@@ -6,43 +6,128 @@
 
 #include <entt/entity/entity.hpp>
 
-void InputSystem::_handleManualInput(const MetaData &metaData) const {
-    switch (_inputEvent.key.key) {
+Command InputSystem::_commandForKey(const SDL_Keycode &key) {
+    switch (key) {
         case SDLK_UP :
-            metaData._currentCommand = Command::JUMP;
-            break;
+            return Command::JUMP;
         case SDLK_LEFT:
-            metaData._currentCommand = Command::MOVE_LEFT;
-            break;
+            return Command::MOVE_LEFT;
         case SDLK_RIGHT:
-            metaData._currentCommand = Command::MOVE_RIGHT;
-            break;
+            return Command::MOVE_RIGHT;
         case SDLK_R:
-            metaData._currentCommand = Command::RESET_POSITION;
-            break;
+            return Command::RESET_POSITION;
         default:
-            metaData._currentCommand = Command::EMPTY_COMMAND;
+            return Command::EMPTY_COMMAND;
     }
 }
 
-void InputSystem::_handleInput(const MetaData &metaData) const {
-    switch (metaData._controlledBy) {
-        case ControlledBy::MANUAL:
-            _handleManualInput(metaData);
-            break;
-        // add more input support (AI, network)
-        default: ;
+Command InputSystem::_nextManualCommand() {
+    // fresh presses first, in the order they happened
+    while (_queueCount > 0) {
+        const KeyPress press = _keyPresses[_queueHead];
+        _queueHead = (_queueHead + 1) % INPUT_QUEUE_CAPACITY;
+        _queueCount--;
+
+        const Command command = _commandForKey(press._key);
+        if (command != Command::EMPTY_COMMAND) {
+            if (command == Command::MOVE_LEFT || command == Command::MOVE_RIGHT) {
+                _ticksSinceHeldMove = 0;
+            }
+            return command;
+        }
+    }
+
+    // then keep pushing while an arrow key is held down
+    _ticksSinceHeldMove++;
+    if (_ticksSinceHeldMove < HELD_MOVE_INTERVAL_TICKS) {
+        return Command::EMPTY_COMMAND;
+    }
+
+    const bool left = _heldKeys[SDL_SCANCODE_LEFT];
+    const bool right = _heldKeys[SDL_SCANCODE_RIGHT];
+    if (left == right) {
+        return Command::EMPTY_COMMAND;
     }
+
+    _ticksSinceHeldMove = 0;
+    return left ? Command::MOVE_LEFT : Command::MOVE_RIGHT;
 }
 
-void InputSystem::setSdlEvent(const SDL_Event &event) {
-    _inputEvent = event;
+void InputSystem::_handleManualInput(const entt::registry &registry) {
+    const Command command = _nextManualCommand();
+    if (command == Command::EMPTY_COMMAND) {
+        return;
+    }
+
+    // only the entities carrying the tag, however large the world is
+    for (auto [entity, metaData] : registry.view<ManualControlled, MetaData>(entt::exclude<Parked>).each()) {
+        metaData._currentCommand = command;
+    }
 }
 
-void InputSystem::processInput(const entt::registry &registry) {
-    auto view = registry.view<MetaData>();
-    for (auto [entity, metaData] : view.each()) {
-        _handleInput(metaData);
+void InputSystem::_handleNetworkInput(const entt::registry &registry) {
+    if (!_networkQueue) {
+        return;
+    }
+
+    _networkCommands.fill(Command::EMPTY_COMMAND);
+
+    // a client sending faster than the tick rate only gets its latest command through
+    NetCommand netCommand{};
+    bool received = false;
+    while (_networkQueue->pop(netCommand)) {
+        if (netCommand._clientId < MAX_NET_CLIENTS) {
+            _networkCommands[netCommand._clientId] = netCommand._command;
+            received = true;
+        }
     }
-    _inputEvent = {}; // reset event
+
+    if (!received) {
+        return;
+    }
+
+    for (auto [entity, networkControlled, metaData] : registry.view<NetworkControlled, MetaData>(entt::exclude<Parked>).each()) {
+        if (networkControlled._clientId >= MAX_NET_CLIENTS) {
+            continue;
+        }
+
+        const Command command = _networkCommands[networkControlled._clientId];
+        if (command != Command::EMPTY_COMMAND) {
+            metaData._currentCommand = command;
+        }
+    }
+}
+
+void InputSystem::queueSdlEvent(const SDL_Event &event) {
+    if (event.type != SDL_EVENT_KEY_DOWN && event.type != SDL_EVENT_KEY_UP) {
+        return;
+    }
+
+    if (event.key.scancode >= 0 && event.key.scancode < SDL_SCANCODE_COUNT) {
+        _heldKeys[event.key.scancode] = event.key.down;
+    }
+
+    // os key repeat is ignored, held keys are handled per tick instead
+    if (event.type != SDL_EVENT_KEY_DOWN || event.key.repeat) {
+        return;
+    }
+
+    if (_queueCount == INPUT_QUEUE_CAPACITY) {
+        // full, drop the oldest press
+        _queueHead = (_queueHead + 1) % INPUT_QUEUE_CAPACITY;
+        _queueCount--;
+    }
+
+    _keyPresses[(_queueHead + _queueCount) % INPUT_QUEUE_CAPACITY] = { event.key.key };
+    _queueCount++;
+}
+
+bool InputSystem::isKeyHeld(const SDL_Scancode &scancode) const {
+    return scancode >= 0 && scancode < SDL_SCANCODE_COUNT && _heldKeys[scancode];
+}
+
+void InputSystem::processInput(const entt::registry &registry) {
+    _handleManualInput(registry);
+    _handleNetworkInput(registry);
+    // AI balls are driven by AiSystem
 }
@@ -5,26 +5,57 @@
 #ifndef BOUNCEPP_INPUTSYSTEM_H
 #define BOUNCEPP_INPUTSYSTEM_H
 
+#include <array>
 #include <entt/entt.hpp>
 #include <SDL3/SDL_events.h>
 
 #include "../components/components.hpp"
+#include "../../net/NetCommand.h"
 
 using namespace  components;
 
+// key presses queued between ticks, more than a frame's worth so nothing is dropped
+constexpr int INPUT_QUEUE_CAPACITY = 64;
+
+// while an arrow key is held the ball is pushed every this many ticks
+constexpr int HELD_MOVE_INTERVAL_TICKS = 2;
+
 class InputSystem {
 
 private:
-    SDL_Event _inputEvent;
-    // void _handleNetworkInput();
-    // void _handleAiInput();
-    void _handleManualInput(const MetaData &metaData) const;
-    void _handleInput(const MetaData &metaData) const; // main routing function
+    struct KeyPress {
+        SDL_Keycode _key;
+    };
+
+    // ring buffer of key presses, each tick consumes at most one command worth of presses
+    std::array<KeyPress, INPUT_QUEUE_CAPACITY> _keyPresses{};
+    int _queueHead = 0;
+    int _queueCount = 0;
+
+    std::array<bool, SDL_SCANCODE_COUNT> _heldKeys{};
+    int _ticksSinceHeldMove = 0;
+
+    static Command _commandForKey(const SDL_Keycode &key);
+    Command _nextManualCommand();
+
+    // drained every tick, only the latest command per client is applied
+    NetCommandQueue *_networkQueue = nullptr;
+    std::array<Command, MAX_NET_CLIENTS> _networkCommands{};
+
+    void _handleNetworkInput(const entt::registry &registry);
+    void _handleManualInput(const entt::registry &registry);
 
 public:
-    void setSdlEvent(const SDL_Event &event);
+    // queues keyboard events, call for every polled event of the frame
+    void queueSdlEvent(const SDL_Event &event);
+
+    bool isKeyHeld(const SDL_Scancode &scancode) const;
+
+    // commands from NetworkServer's receive thread, nullptr disables network input
+    void setNetworkQueue(NetCommandQueue *queue) { _networkQueue = queue; }
+
     void processInput(const entt::registry &registry);
 };
 
 
-#endif //BOUNCEPP_INPUTSYSTEM_H
\ No newline at end of file
+#endif //BOUNCEPP_INPUTSYSTEM_H
@@ -0,0 +1,84 @@
+#include "RenderSnapshotSystem.h"
+
+RenderSnapshotSystem::RenderSnapshotSystem(entt::registry &registry, const b2WorldId &worldId) : _registry(registry), _worldId(worldId) {
+    _registry.on_construct<StaticTag>().connect<&RenderSnapshotSystem::markStaticsDirty>(*this);
+    _registry.on_destroy<StaticTag>().connect<&RenderSnapshotSystem::markStaticsDirty>(*this);
+}
+
+RenderSnapshotSystem::~RenderSnapshotSystem() {
+    _registry.on_construct<StaticTag>().disconnect(this);
+    _registry.on_destroy<StaticTag>().disconnect(this);
+}
+
+void RenderSnapshotSystem::markStaticsDirty(entt::registry &, entt::entity) {
+    _staticsDirty = true;
+}
+
+void RenderSnapshotSystem::rebuildStatics() {
+    // a new list rather than an edit, snapshots the render thread still holds keep the old one
+    auto statics = std::make_shared<std::vector<StaticInstance>>();
+    statics->reserve(_registry.storage<StaticTag>().size());
+    for (auto [entity, renderData] : _registry.view<RenderingData, StaticTag>().each()) {
+        statics->push_back({ renderData._rect, static_cast<float>(renderData._rotDeg), renderData._sprite });
+    }
+
+    _statics = std::move(statics);
+    _staticVersion++;
+    _staticsDirty = false;
+}
+
+RenderInstance RenderSnapshotSystem::makeInstance(const RenderingData &renderData) {
+    return {
+        renderData._rect,
+        renderData._prevPos,
+        static_cast<float>(renderData._rotDeg),
+        static_cast<float>(renderData._prevRotDeg),
+        renderData._sprite
+    };
+}
+
+bool RenderSnapshotSystem::addVisibleShape(const b2ShapeId shapeId, void *context) {
+    auto &system = *static_cast<RenderSnapshotSystem*>(context);
+    if (b2Body_GetType(b2Shape_GetBody(shapeId)) == b2_staticBody) {
+        return true; // part of the static list
+    }
+
+    const auto entity = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(b2Shape_GetUserData(shapeId)));
+    if (!system._registry.valid(entity)) {
+        return true;
+    }
+
+    if (const auto *renderData = system._registry.try_get<RenderingData>(entity)) {
+        system._capturing->_dynamic.push_back(makeInstance(*renderData));
+    }
+    return true;
+}
+
+void RenderSnapshotSystem::capture(RenderSnapshot &snapshot, const SDL_FRect &area, const uint32_t &tick, const double &timeStep) {
+    if (_staticsDirty) {
+        rebuildStatics();
+    }
+
+    snapshot._tick = tick;
+    snapshot._publishedNs = SDL_GetTicksNS();
+    snapshot._timeStep = timeStep;
+    snapshot._statics = _statics;
+    snapshot._staticVersion = _staticVersion;
+
+    const auto targets = _registry.view<CameraTarget, RenderingData>(entt::exclude<Parked>);
+    snapshot._hasCameraTarget = targets.begin() != targets.end();
+    if (snapshot._hasCameraTarget) {
+        snapshot._cameraTarget = makeInstance(targets.get<RenderingData>(*targets.begin()));
+    }
+
+    snapshot._dynamic.clear(); // keeps capacity
+    _capturing = &snapshot;
+
+    const b2AABB aabb = {
+        { px_to_m(area.x - SNAPSHOT_VIEW_MARGIN), px_to_m(area.y - SNAPSHOT_VIEW_MARGIN) },
+        { px_to_m(area.x + area.w + SNAPSHOT_VIEW_MARGIN), px_to_m(area.y + area.h + SNAPSHOT_VIEW_MARGIN) }
+    };
+    b2World_OverlapAABB(_worldId, aabb, b2DefaultQueryFilter(), &RenderSnapshotSystem::addVisibleShape, this);
+
+    _capturing = nullptr;
+}
@@ -0,0 +1,82 @@
+#ifndef BOUNCEPP_RENDERSNAPSHOTSYSTEM_H
+#define BOUNCEPP_RENDERSNAPSHOTSYSTEM_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <box2d/box2d.h>
+#include <entt/entt.hpp>
+#include <SDL3/SDL.h>
+
+#include "../components/components.hpp"
+
+using namespace components;
+
+// world pixels captured around the render thread's last view, covers camera movement until the next snapshot
+constexpr float SNAPSHOT_VIEW_MARGIN = 256.0f;
+
+// one dynamic entity as the renderer needs it, current and previous tick for interpolation
+struct RenderInstance {
+    SDL_FRect _rect;
+    SDL_FPoint _prevPos;
+    float _rotDeg;
+    float _prevRotDeg;
+    SpriteHandle _sprite;
+};
+
+struct StaticInstance {
+    SDL_FRect _rect;
+    float _rotDeg;
+    SpriteHandle _sprite;
+};
+
+// everything the render thread needs for one tick, so it never touches the registry or box2d
+struct RenderSnapshot {
+    uint32_t _tick = 0;
+    uint64_t _publishedNs = 0; // SDL_GetTicksNS when the tick finished
+    double _timeStep = 0.0;    // seconds, the render thread interpolates over one step
+
+    bool _hasCameraTarget = false;
+    RenderInstance _cameraTarget{};
+
+    std::vector<RenderInstance> _dynamic; // inside the requested area only
+
+    // every static entity, shared between snapshots until static entities come or go
+    std::shared_ptr<const std::vector<StaticInstance>> _statics;
+    uint64_t _staticVersion = 0;
+};
+
+// sim thread side of the render pipeline: copies what is near the view into a RenderSnapshot.
+// dynamic entities are found through box2d's broadphase, the static list is only rebuilt when
+// StaticTag entities come or go
+class RenderSnapshotSystem {
+
+private:
+    entt::registry &_registry;
+    b2WorldId _worldId;
+
+    std::shared_ptr<const std::vector<StaticInstance>> _statics;
+    uint64_t _staticVersion = 0;
+    bool _staticsDirty = true;
+
+    RenderSnapshot *_capturing = nullptr; // snapshot being filled by the broadphase callback
+
+    void markStaticsDirty(entt::registry &registry, entt::entity entity);
+    void rebuildStatics();
+
+    static RenderInstance makeInstance(const RenderingData &renderData);
+    static bool addVisibleShape(b2ShapeId shapeId, void *context);
+
+public:
+    explicit RenderSnapshotSystem(entt::registry &registry, const b2WorldId &worldId);
+    ~RenderSnapshotSystem();
+
+    RenderSnapshotSystem(const RenderSnapshotSystem&) = delete;
+    RenderSnapshotSystem& operator=(const RenderSnapshotSystem&) = delete;
+
+    // overwrites snapshot with the entities overlapping area (world pixels) plus SNAPSHOT_VIEW_MARGIN,
+    // reusing the snapshot's capacity
+    void capture(RenderSnapshot &snapshot, const SDL_FRect &area, const uint32_t &tick, const double &timeStep);
+};
+
+#endif //BOUNCEPP_RENDERSNAPSHOTSYSTEM_H
@@ -0,0 +1,282 @@
+#include "RenderSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CameraSystem.h"
+#include "../../core/Profiler.h"
+
+static constexpr SDL_FColor WHITE = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+// blend the previous and current physics transform for smooth rendering between fixed ticks
+static SDL_FRect interpolateRect(const RenderInstance &instance, const float alpha) {
+    SDL_FRect rect = instance._rect;
+    rect.x = instance._prevPos.x + (instance._rect.x - instance._prevPos.x) * alpha;
+    rect.y = instance._prevPos.y + (instance._rect.y - instance._prevPos.y) * alpha;
+    return rect;
+}
+
+static double interpolateRotation(const RenderInstance &instance, const float alpha) {
+    // take the short way round when the angle wraps at +-180
+    const double delta = std::fmod(static_cast<double>(instance._rotDeg) - instance._prevRotDeg + 540.0, 360.0) - 180.0;
+    return instance._prevRotDeg + delta * alpha;
+}
+
+RenderSystem::RenderSystem(SDL_Renderer *renderer, const AssetManager &assets)
+    : _renderer(renderer), _assets(assets), _staticGrid(STATIC_TILE_SIZE / 4.0f) {
+}
+
+RenderSystem::~RenderSystem() {
+    destroyStaticTiles();
+}
+
+void RenderSystem::ensureQuadIndices(const size_t quadCount) {
+    const size_t currentQuads = _quadIndices.size() / 6;
+    if (currentQuads >= quadCount) {
+        return;
+    }
+
+    _quadIndices.reserve(quadCount * 6);
+    for (size_t quad = currentQuads; quad < quadCount; quad++) {
+        const int first = static_cast<int>(quad * 4);
+        _quadIndices.insert(_quadIndices.end(), { first, first + 1, first + 2, first + 2, first + 3, first });
+    }
+}
+
+void RenderSystem::writeQuad(SDL_Vertex *vertices, const SDL_FRect &rect, const double rotDeg, const SDL_FRect &uv) {
+    // rotate the corners around the rect centre, clockwise like SDL_RenderTextureRotated
+    const float radians = static_cast<float>(rotDeg * M_PI / 180.0);
+    const float cos = std::cos(radians);
+    const float sin = std::sin(radians);
+
+    const float halfW = rect.w / 2.0f;
+    const float halfH = rect.h / 2.0f;
+    const float centerX = rect.x + halfW;
+    const float centerY = rect.y + halfH;
+
+    const float cornerX[4] = { -halfW, halfW, halfW, -halfW };
+    const float cornerY[4] = { -halfH, -halfH, halfH, halfH };
+    const float texU[4] = { uv.x, uv.x + uv.w, uv.x + uv.w, uv.x };
+    const float texV[4] = { uv.y, uv.y, uv.y + uv.h, uv.y + uv.h };
+
+    for (int i = 0; i < 4; i++) {
+        SDL_Vertex &vertex = vertices[i];
+        vertex.position = {
+            centerX + cornerX[i] * cos - cornerY[i] * sin,
+            centerY + cornerX[i] * sin + cornerY[i] * cos
+        };
+        vertex.color = WHITE;
+        vertex.tex_coord = { texU[i], texV[i] };
+    }
+}
+
+void RenderSystem::appendQuad(SpriteBatch &batch, const SDL_FRect &rect, const double rotDeg, const SDL_FRect &uv) {
+    const size_t first = batch._vertices.size();
+    batch._vertices.resize(first + 4);
+    writeQuad(batch._vertices.data() + first, rect, rotDeg, uv);
+}
+
+void RenderSystem::submitGeometry(const int page, const SDL_Vertex *vertices, const size_t vertexCount) {
+    if (vertexCount == 0) {
+        return;
+    }
+
+    const size_t quadCount = vertexCount / 4;
+    ensureQuadIndices(quadCount);
+
+    SDL_RenderGeometry(_renderer, _assets.getPageTexture(page), vertices, static_cast<int>(vertexCount),
+                       _quadIndices.data(), static_cast<int>(quadCount * 6));
+}
+
+void RenderSystem::submitBatches(std::vector<SpriteBatch> &batches) {
+    for (size_t i = 0; i < batches.size(); i++) {
+        submitGeometry(static_cast<int>(i), batches[i]._vertices.data(), batches[i]._vertices.size());
+    }
+}
+
+void RenderSystem::invalidateStaticLayer() {
+    destroyStaticTiles();
+}
+
+void RenderSystem::destroyStaticTiles() {
+    for (const auto &[key, tile] : _staticTiles) {
+        if (tile._texture) {
+            SDL_DestroyTexture(tile._texture);
+        }
+    }
+    _staticTiles.clear();
+}
+
+void RenderSystem::rebuildStaticGrid(const RenderSnapshot &snapshot) {
+    BOUNCEPP_PROFILE_SCOPE("rebuildStaticGrid");
+
+    _statics = snapshot._statics;
+    _staticVersion = snapshot._staticVersion;
+
+    _staticGrid.clear();
+    if (_statics) {
+        for (size_t i = 0; i < _statics->size(); i++) {
+            _staticGrid.add((*_statics)[i]._rect, static_cast<uint32_t>(i));
+        }
+    }
+    _staticGrid.build();
+
+    destroyStaticTiles();
+}
+
+RenderSystem::StaticTile RenderSystem::buildStaticTile(const int tileX, const int tileY) {
+    BOUNCEPP_PROFILE_SCOPE("buildStaticTile");
+
+    StaticTile tile = { nullptr, {
+        static_cast<float>(tileX * STATIC_TILE_SIZE),
+        static_cast<float>(tileY * STATIC_TILE_SIZE),
+        static_cast<float>(STATIC_TILE_SIZE),
+        static_cast<float>(STATIC_TILE_SIZE)
+    } };
+
+    _tileBatches.resize(_assets.getPageCount());
+    for (auto &batch : _tileBatches) {
+        batch._vertices.clear();
+    }
+
+    // tile-local coordinates
+    bool empty = true;
+    _staticGrid.query(tile._bounds, [&](const SDL_FRect &rect, const uint32_t id) {
+        const StaticInstance &instance = (*_statics)[id];
+        const Sprite &sprite = _assets.getSprite(instance._sprite);
+        if (sprite._page < 0) {
+            return;
+        }
+
+        const SDL_FRect local = { rect.x - tile._bounds.x, rect.y - tile._bounds.y, rect.w, rect.h };
+        appendQuad(_tileBatches[sprite._page], local, instance._rotDeg, sprite._uv);
+        empty = false;
+    });
+
+    if (empty) {
+        return tile;
+    }
+
+    // draw the tile once into its own target texture
+    SDL_Texture *texture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, STATIC_TILE_SIZE, STATIC_TILE_SIZE);
+    if (!texture) {
+        SDL_Log("static layer tile could not be created: %s", SDL_GetError());
+        return tile;
+    }
+
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(_renderer);
+
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderTarget(_renderer, texture);
+    SDL_SetRenderDrawColor(_renderer, 0, 0, 0, 0); // transparent, the background shows through
+    SDL_RenderClear(_renderer);
+    submitBatches(_tileBatches);
+
+    SDL_SetRenderTarget(_renderer, previousTarget);
+
+    tile._texture = texture;
+    return tile;
+}
+
+static uint64_t tileKey(const int tileX, const int tileY) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(tileX)) << 32) | static_cast<uint32_t>(tileY);
+}
+
+void RenderSystem::drawStaticLayer(const Camera &camera, const SDL_FRect &visibleArea) {
+    const int firstTileX = static_cast<int>(std::floor(visibleArea.x / STATIC_TILE_SIZE));
+    const int firstTileY = static_cast<int>(std::floor(visibleArea.y / STATIC_TILE_SIZE));
+    const int lastTileX = static_cast<int>(std::floor((visibleArea.x + visibleArea.w) / STATIC_TILE_SIZE));
+    const int lastTileY = static_cast<int>(std::floor((visibleArea.y + visibleArea.h) / STATIC_TILE_SIZE));
+
+    // drop tiles that scrolled away, a one tile ring is kept so small camera moves do not rebuild
+    std::erase_if(_staticTiles, [&](const auto &entry) {
+        const int tileX = static_cast<int32_t>(entry.first >> 32);
+        const int tileY = static_cast<int32_t>(entry.first & 0xFFFFFFFFu);
+        if (tileX >= firstTileX - 1 && tileX <= lastTileX + 1 && tileY >= firstTileY - 1 && tileY <= lastTileY + 1) {
+            return false;
+        }
+        if (entry.second._texture) {
+            SDL_DestroyTexture(entry.second._texture);
+        }
+        return true;
+    });
+
+    // one blit per visible tile
+    for (int tileY = firstTileY; tileY <= lastTileY; tileY++) {
+        for (int tileX = firstTileX; tileX <= lastTileX; tileX++) {
+            auto it = _staticTiles.find(tileKey(tileX, tileY));
+            if (it == _staticTiles.end()) {
+                it = _staticTiles.emplace(tileKey(tileX, tileY), buildStaticTile(tileX, tileY)).first;
+            }
+
+            if (it->second._texture) {
+                const SDL_FRect screen = CameraSystem::worldToScreen(camera, it->second._bounds);
+                SDL_RenderTexture(_renderer, it->second._texture, nullptr, &screen);
+            }
+        }
+    }
+}
+
+void RenderSystem::render(const RenderSnapshot &snapshot, const Camera &camera, const float &alpha) {
+    int outputW = 0, outputH = 0;
+    SDL_GetCurrentRenderOutputSize(_renderer, &outputW, &outputH);
+    camera._viewport = { static_cast<float>(outputW), static_cast<float>(outputH) };
+
+    const SDL_FRect visibleArea = CameraSystem::getVisibleArea(camera);
+
+    if (snapshot._staticVersion != _staticVersion) {
+        rebuildStaticGrid(snapshot);
+    }
+    drawStaticLayer(camera, visibleArea);
+
+    _frameScratch.reset();
+
+    // the snapshot covers more than the view so the camera can move between snapshots, cull the rest here
+    const float left = visibleArea.x - CULL_MARGIN;
+    const float top = visibleArea.y - CULL_MARGIN;
+    const float right = visibleArea.x + visibleArea.w + CULL_MARGIN;
+    const float bottom = visibleArea.y + visibleArea.h + CULL_MARGIN;
+
+    // cull and count quads per atlas page first, so every page's vertices get one exactly sized range
+    const auto pageCount = static_cast<size_t>(_assets.getPageCount());
+    const std::span<VisibleQuad> visible = _frameScratch.allocate<VisibleQuad>(snapshot._dynamic.size());
+    const std::span<size_t> pageStart = _frameScratch.allocate<size_t>(pageCount + 1);
+    std::fill(pageStart.begin(), pageStart.end(), 0);
+
+    size_t visibleCount = 0;
+    for (const auto &instance : snapshot._dynamic) {
+        const SDL_FRect &rect = instance._rect;
+        if (rect.x > right || rect.y > bottom || rect.x + rect.w < left || rect.y + rect.h < top) {
+            continue;
+        }
+
+        const Sprite &sprite = _assets.getSprite(instance._sprite);
+        if (sprite._page < 0) {
+            continue;
+        }
+
+        visible[visibleCount++] = { sprite._page, CameraSystem::worldToScreen(camera, interpolateRect(instance, alpha)),
+                                    interpolateRotation(instance, alpha), sprite._uv };
+        pageStart[sprite._page + 1]++;
+    }
+    _visibleDynamicCount = visibleCount;
+
+    for (size_t page = 1; page <= pageCount; page++) {
+        pageStart[page] += pageStart[page - 1];
+    }
+
+    // build the dynamic quads, the sprite's page picks the range so there is no per-entity draw path
+    const std::span<SDL_Vertex> vertices = _frameScratch.allocate<SDL_Vertex>(visibleCount * 4);
+    const std::span<size_t> pageCursor = _frameScratch.allocate<size_t>(pageCount);
+    std::copy(pageStart.begin(), pageStart.begin() + static_cast<std::ptrdiff_t>(pageCount), pageCursor.begin());
+
+    for (size_t i = 0; i < visibleCount; i++) {
+        const VisibleQuad &quad = visible[i];
+        writeQuad(vertices.data() + pageCursor[quad._page]++ * 4, quad._screen, quad._rotDeg, quad._uv);
+    }
+
+    // submit one draw call per atlas page
+    for (size_t page = 0; page < pageCount; page++) {
+        submitGeometry(static_cast<int>(page), vertices.data() + pageStart[page] * 4, (pageStart[page + 1] - pageStart[page]) * 4);
+    }
+}
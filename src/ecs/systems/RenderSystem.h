@@ -0,0 +1,104 @@
+#ifndef BOUNCEPP_RENDERSYSTEM_H
+#define BOUNCEPP_RENDERSYSTEM_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <SDL3/SDL.h>
+
+#include "RenderSnapshotSystem.h"
+#include "../components/components.hpp"
+#include "../../assets/AssetManager.h"
+#include "../../core/ScratchArena.h"
+#include "../../core/SpatialGrid.h"
+
+using namespace components;
+
+// side length in pixels of one cached static layer tile
+constexpr int STATIC_TILE_SIZE = 1024;
+
+// world pixels added around the view when culling dynamic entities, covers the interpolation between ticks
+constexpr float CULL_MARGIN = 64.0f;
+
+// draws a RenderSnapshot as the Camera sees it, textured quads with one SDL_RenderGeometry call per atlas page.
+// only reads the snapshot, so it can run on its own thread while the simulation produces the next one.
+// static entities are found through a grid and drawn once into cached tiles, tiles are only built
+// for the visible area and dropped once they scroll out of view. the snapshot's dynamic entities are
+// already limited to the area around the view, see RenderSnapshotSystem.
+// entities whose sprite is not decoded yet are skipped.
+class RenderSystem {
+
+private:
+    // vertices of all quads on the same atlas page, kept between tiles so their capacity is reused
+    struct SpriteBatch {
+        std::vector<SDL_Vertex> _vertices;
+    };
+
+    // a dynamic entity that survived culling, in screen space
+    struct VisibleQuad {
+        int _page;
+        SDL_FRect _screen;
+        double _rotDeg;
+        SDL_FRect _uv;
+    };
+
+    // one target texture holding the static geometry of a STATIC_TILE_SIZE square of the world,
+    // null when nothing static overlaps the square
+    struct StaticTile {
+        SDL_Texture *_texture;
+        SDL_FRect _bounds;
+    };
+
+    SDL_Renderer *_renderer;
+    const AssetManager &_assets;
+
+    // the dynamic quads of one frame, sorted by atlas page. reset at the start of every render
+    ScratchArena _frameScratch;
+
+    // every quad uses the same 0-1-2 2-3-0 pattern, so a single index buffer serves all batches
+    std::vector<int> _quadIndices;
+
+    // static entities of the last snapshot by world rect, ids index _statics.
+    // rebuilt when a snapshot arrives with a new static version
+    std::shared_ptr<const std::vector<StaticInstance>> _statics;
+    uint64_t _staticVersion = 0;
+    SpatialGrid _staticGrid;
+
+    std::unordered_map<uint64_t, StaticTile> _staticTiles; // by tile coordinate
+    std::vector<SpriteBatch> _tileBatches;                 // reused while a tile is drawn
+
+    size_t _visibleDynamicCount = 0;
+
+    void ensureQuadIndices(size_t quadCount);
+    void submitGeometry(int page, const SDL_Vertex *vertices, size_t vertexCount);
+    void submitBatches(std::vector<SpriteBatch> &batches);
+
+    void destroyStaticTiles();
+    void rebuildStaticGrid(const RenderSnapshot &snapshot);
+    StaticTile buildStaticTile(int tileX, int tileY);
+    void drawStaticLayer(const Camera &camera, const SDL_FRect &visibleArea);
+
+    // writes the four corners of rect to vertices
+    static void writeQuad(SDL_Vertex *vertices, const SDL_FRect &rect, double rotDeg, const SDL_FRect &uv);
+    static void appendQuad(SpriteBatch &batch, const SDL_FRect &rect, double rotDeg, const SDL_FRect &uv);
+
+public:
+    explicit RenderSystem(SDL_Renderer *renderer, const AssetManager &assets);
+    ~RenderSystem();
+
+    RenderSystem(const RenderSystem&) = delete;
+    RenderSystem& operator=(const RenderSystem&) = delete;
+
+    // forces the static layer to be redrawn, call when render targets were reset or when sprites became ready
+    void invalidateStaticLayer();
+
+    // alpha blends between the snapshot's previous and current tick, 0 = previous, 1 = current.
+    // camera's viewport is set to the output size
+    void render(const RenderSnapshot &snapshot, const Camera &camera, const float &alpha);
+
+    // entities drawn last frame, static ones are not counted
+    size_t getVisibleDynamicCount() const { return _visibleDynamicCount; }
+    size_t getCachedTileCount() const { return _staticTiles.size(); }
+};
+
+#endif //BOUNCEPP_RENDERSYSTEM_H
@@ -4,31 +4,188 @@
 
 #include "physicsSystem.h"
 
+#include <algorithm>
+
+#include "../../core/FastMath.h"
+#include "../../core/Profiler.h"
+
 using namespace components;
 
+void* PhysicsSystem::enqueueTask(b2TaskCallback *task, const int itemCount, const int minRange, void *taskContext, void *userContext) {
+    return static_cast<TaskScheduler*>(userContext)->enqueue(task, itemCount, minRange, taskContext);
+}
+
+void PhysicsSystem::finishTask(void *userTask, void *userContext) {
+    static_cast<TaskScheduler*>(userContext)->finish(userTask);
+}
+
 const b2WorldId& PhysicsSystem::getWorldId() {
     return _worldId;
 }
 
+int PhysicsSystem::getWorkerCount() const {
+    return _taskScheduler.getWorkerCount();
+}
+
+TaskScheduler& PhysicsSystem::getTaskScheduler() {
+    return _taskScheduler;
+}
+
+float PhysicsSystem::getTimeStep() const {
+    return _timeStep;
+}
+
+float PhysicsSystem::getTickRate() const {
+    return 1.0f / _timeStep;
+}
+
+void PhysicsSystem::setTickRate(const float &ticksPerSecond) {
+    _timeStep = 1.0f / std::clamp(ticksPerSecond, MIN_TICK_RATE, MAX_TICK_RATE);
+}
+
+int PhysicsSystem::getSubStepCount() const {
+    return _subStepCount;
+}
+
+void PhysicsSystem::setSubStepCount(const int &subStepCount) {
+    _subStepCount = std::clamp(subStepCount, 1, MAX_SUB_STEPS);
+}
+
 void PhysicsSystem::updatePhysics() {
-    b2World_Step(_worldId, 1.0f/60.0f, 4);
+    b2World_Step(_worldId, _timeStep, _subStepCount);
+    BOUNCEPP_PROFILE_PHYSICS(_worldId);
 }
 
-void PhysicsSystem::syncPhysicsWithRendering(const entt::registry &registry) {
-    auto physicsRenderingView = registry.view<PhysicsData, RenderingData, MetaData>();
-    for (auto [entity, physicsData, renderingData, metaData] : physicsRenderingView.each()) {
-        if (metaData._entityType == EntityType::PLATFORM)
+// the scheduler queues even a single range, batches too small to split are cheaper run in place
+template<typename Function>
+static void syncRanges(TaskScheduler &scheduler, const int &itemCount, Function &function) {
+    if (itemCount < 2 * SYNC_CHUNK_SIZE) {
+        function(0, itemCount, 0);
+        return;
+    }
+    scheduler.parallelFor(itemCount, SYNC_CHUNK_SIZE, function);
+}
+
+void PhysicsSystem::gatherTransforms(const b2BodyMoveEvent *events, const entt::storage_for_t<RenderingData> &renderStorage,
+                                     const int &start, const int &end) {
+    for (int i = start; i < end; i++) {
+        const b2BodyMoveEvent &event = events[i];
+        const auto entity = static_cast<entt::entity>(reinterpret_cast<uintptr_t>(event.userData));
+
+        // contains also rejects destroyed entities since it compares versions
+        const RenderingData *renderingData = renderStorage.contains(entity) ? &renderStorage.get(entity) : nullptr;
+        _syncTargets[i] = renderingData;
+        _movedThisTick[i] = renderingData ? entity : entt::null;
+
+        _syncX[i] = event.transform.p.x;
+        _syncY[i] = event.transform.p.y;
+        _syncCos[i] = event.transform.q.c;
+        _syncSin[i] = event.transform.q.s;
+        _syncHalfW[i] = renderingData ? renderingData->_rect.w / 2.0f : 0.0f;
+        _syncHalfH[i] = renderingData ? renderingData->_rect.h / 2.0f : 0.0f;
+    }
+}
+
+void PhysicsSystem::convertTransforms(const int &start, const int &end) {
+    constexpr float RAD_TO_DEG = 180.0f / static_cast<float>(M_PI);
+
+    // plain float arrays and no branches, the compiler turns this into simd
+    const float *__restrict x = _syncX.data();
+    const float *__restrict y = _syncY.data();
+    const float *__restrict cosine = _syncCos.data();
+    const float *__restrict sine = _syncSin.data();
+    const float *__restrict halfW = _syncHalfW.data();
+    const float *__restrict halfH = _syncHalfH.data();
+    float *__restrict outX = _syncOutX.data();
+    float *__restrict outY = _syncOutY.data();
+    float *__restrict outDeg = _syncOutDeg.data();
+
+    for (int i = start; i < end; i++) {
+        outX[i] = x[i] * PPM - halfW[i];
+        outY[i] = y[i] * PPM - halfH[i];
+        outDeg[i] = fastAtan2(sine[i], cosine[i]) * RAD_TO_DEG;
+    }
+}
+
+void PhysicsSystem::scatterTransforms(const int &start, const int &end) const {
+    for (int i = start; i < end; i++) {
+        const RenderingData *renderingData = _syncTargets[i];
+        if (renderingData == nullptr) {
             continue;
+        }
+
+        // keep the last transform around for interpolation
+        renderingData->_prevPos = { renderingData->_rect.x, renderingData->_rect.y };
+        renderingData->_prevRotDeg = renderingData->_rotDeg;
+
+        renderingData->_rect.x = _syncOutX[i];
+        renderingData->_rect.y = _syncOutY[i];
+        renderingData->_rotDeg = _syncOutDeg[i];
+    }
+}
 
-        // only update for balls
-        auto [x, y] = b2Body_GetPosition(physicsData._physicsBodyId);
-        auto [rot_x, rot_y] =  b2Body_GetRotation(physicsData._physicsBodyId);
-        renderingData._rotDeg = atan2(rot_y, rot_x) * 180.0 / M_PI;
-        renderingData._rect.x = m_to_px(x) - renderingData._rect.w / 2.0f;
-        renderingData._rect.y = m_to_px(y) - renderingData._rect.h / 2.0f;
+void PhysicsSystem::syncPhysicsWithRendering(const entt::registry &registry) {
+    const auto *renderStorage = registry.storage<RenderingData>();
+    if (renderStorage == nullptr) {
+        _movedLastTick.clear();
+        return;
     }
+
+    // bodies that moved last tick but not this one have come to rest, collapse their interpolation range.
+    // this finishes before the move pass below rewrites the ones that are still moving
+    auto settle = [&](const int start, const int end, uint32_t) {
+        for (int i = start; i < end; i++) {
+            const auto entity = _movedLastTick[i];
+            if (entity == entt::null || !renderStorage->contains(entity)) {
+                continue;
+            }
+
+            const RenderingData &renderingData = renderStorage->get(entity);
+            renderingData._prevPos = { renderingData._rect.x, renderingData._rect.y };
+            renderingData._prevRotDeg = renderingData._rotDeg;
+        }
+    };
+    syncRanges(_taskScheduler, static_cast<int>(_movedLastTick.size()), settle);
+
+    // only bodies box2d actually moved this step, sleeping and static bodies cost nothing
+    const b2BodyEvents bodyEvents = b2World_GetBodyEvents(_worldId);
+    const auto moveCount = static_cast<size_t>(std::max(bodyEvents.moveCount, 0));
+
+    // resize keeps the capacity, so a steady ball count allocates nothing
+    _movedThisTick.resize(moveCount);
+
+    // the scratch block settles at the size of the busiest tick, after that a sync allocates nothing
+    _syncScratch.reset();
+    _syncTargets = _syncScratch.allocate<const RenderingData*>(moveCount);
+    _syncX = _syncScratch.allocate<float>(moveCount);
+    _syncY = _syncScratch.allocate<float>(moveCount);
+    _syncCos = _syncScratch.allocate<float>(moveCount);
+    _syncSin = _syncScratch.allocate<float>(moveCount);
+    _syncHalfW = _syncScratch.allocate<float>(moveCount);
+    _syncHalfH = _syncScratch.allocate<float>(moveCount);
+    _syncOutX = _syncScratch.allocate<float>(moveCount);
+    _syncOutY = _syncScratch.allocate<float>(moveCount);
+    _syncOutDeg = _syncScratch.allocate<float>(moveCount);
+
+    // each body shows up in at most one event, so ranges never write the same RenderingData
+    auto sync = [&](const int start, const int end, uint32_t) {
+        gatherTransforms(bodyEvents.moveEvents, *renderStorage, start, end);
+        convertTransforms(start, end);
+        scatterTransforms(start, end);
+    };
+    syncRanges(_taskScheduler, static_cast<int>(moveCount), sync);
+
+    std::swap(_movedLastTick, _movedThisTick);
 }
 
 void PhysicsSystem::destroyWorld() {
     b2DestroyWorld(_worldId);
 }
+
+void PhysicsSystem::resetWorld() {
+    const MemoryBudgetScope memoryScope(_memory);
+    b2DestroyWorld(_worldId);
+    _worldId = b2CreateWorld(&_worldDef);
+    _movedLastTick.clear();
+    _movedThisTick.clear();
+}
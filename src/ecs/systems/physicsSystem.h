@@ -2,34 +2,110 @@
 #define BOUNCEPP_PHYSICS_H
 
 #include <box2d/box2d.h>
+#include <span>
+#include <vector>
 #include <entt/entt.hpp>
 
 #include "../components/components.hpp"
+#include "../../core/Memory.h"
+#include "../../core/ScratchArena.h"
+#include "../../core/TaskScheduler.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+constexpr float MIN_TICK_RATE = 10.0f;
+constexpr float MAX_TICK_RATE = 480.0f;
+constexpr int MAX_SUB_STEPS = 16;
+
+// move events per sync task, steps with fewer than two chunks sync on the calling thread
+constexpr int SYNC_CHUNK_SIZE = 4096;
+
 class PhysicsSystem {
 
 private:
     b2WorldId _worldId;
     b2WorldDef _worldDef;
 
+    float _timeStep = 1.0f / 60.0f;
+    int _subStepCount = 4;
+
+    // entities whose RenderingData was written by the last sync, entt::null where a move event had no target.
+    // both lists keep their capacity between ticks and are swapped after every sync
+    std::vector<entt::entity> _movedLastTick;
+    std::vector<entt::entity> _movedThisTick;
+
+    // sync gathers the move events into these flat arrays so the conversion runs as one vectorisable loop.
+    // they only live for one sync and are taken from _syncScratch
+    ScratchArena _syncScratch;
+    std::span<const components::RenderingData*> _syncTargets;
+    std::span<float> _syncX;
+    std::span<float> _syncY;
+    std::span<float> _syncCos;
+    std::span<float> _syncSin;
+    std::span<float> _syncHalfW;
+    std::span<float> _syncHalfH;
+    std::span<float> _syncOutX;
+    std::span<float> _syncOutY;
+    std::span<float> _syncOutDeg;
+
+    // box2d memory of the world is charged to it, nullptr leaves it with the caller's budget
+    MemoryBudget *_memory;
+
+    // runs box2d's solver tasks, one worker means the world steps on the calling thread only
+    TaskScheduler _taskScheduler;
+
+    static void* enqueueTask(b2TaskCallback *task, int itemCount, int minRange, void *taskContext, void *userContext);
+    static void finishTask(void *userTask, void *userContext);
+
+    // the three stages of syncing one range of move events, see syncPhysicsWithRendering
+    void gatherTransforms(const b2BodyMoveEvent *events, const entt::storage_for_t<components::RenderingData> &renderStorage, const int &start, const int &end);
+    void convertTransforms(const int &start, const int &end);
+    void scatterTransforms(const int &start, const int &end) const;
+
 public:
-    explicit PhysicsSystem(const float &gravity) {
+    explicit PhysicsSystem(const float &gravity, const int &workerCount = 1, MemoryBudget *memory = nullptr)
+        : _memory(memory), _taskScheduler(workerCount) {
         _worldDef = b2DefaultWorldDef();
         _worldDef.gravity = b2Vec2(0.0, gravity);
+
+        if (_taskScheduler.getWorkerCount() > 1) {
+            _worldDef.workerCount = _taskScheduler.getWorkerCount();
+            _worldDef.enqueueTask = enqueueTask;
+            _worldDef.finishTask = finishTask;
+            _worldDef.userTaskContext = &_taskScheduler;
+        }
+
+        const MemoryBudgetScope memoryScope(_memory);
         _worldId = b2CreateWorld(&_worldDef);
     }
 
     const b2WorldId& getWorldId();
 
+    int getWorkerCount() const;
+
+    // shared with other systems that want to run data-parallel work on the same workers
+    TaskScheduler& getTaskScheduler();
+
+    // fixed simulation rate, each updatePhysics call advances the world by exactly one time step
+    float getTimeStep() const;
+    float getTickRate() const;
+    void setTickRate(const float &ticksPerSecond);
+
+    int getSubStepCount() const;
+    void setSubStepCount(const int &subStepCount);
+
     void updatePhysics();
 
+    // copies the transforms of bodies that moved during the last step into their RenderingData,
+    // large steps are split across the task scheduler's workers
     void syncPhysicsWithRendering(const entt::registry &registry);
 
     void destroyWorld();
+
+    // destroys every body by replacing the world with an empty one built from the same definition
+    void resetWorld();
 };
 
 
@@ -0,0 +1,130 @@
+#include "Level.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+
+using FilePtr = std::unique_ptr<FILE, int(*)(FILE*)>;
+
+static FilePtr openFile(const std::string &path, const char *mode) {
+    return { std::fopen(path.c_str(), mode), std::fclose };
+}
+
+static std::string chunkPath(const std::string &directory, const ChunkCoord &coord) {
+    return directory + "/chunk_" + std::to_string(coord.x) + "_" + std::to_string(coord.y) + ".txt";
+}
+
+ChunkCoord LevelInfo::chunkAt(const float &x, const float &y) const {
+    return { static_cast<int>(std::floor(x / chunkSize)), static_cast<int>(std::floor(y / chunkSize)) };
+}
+
+bool loadLevelInfo(const std::string &directory, LevelInfo &info) {
+    const FilePtr file = openFile(directory + "/level.txt", "r");
+    if (!file) {
+        SDL_Log("level %s has no level.txt", directory.c_str());
+        return false;
+    }
+
+    LevelInfo parsed;
+    parsed.directory = directory;
+    bool hasChunks = false;
+
+    char line[256];
+    while (std::fgets(line, sizeof(line), file.get())) {
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+
+        if (std::sscanf(line, "chunk_size %d", &parsed.chunkSize) == 1) {
+            continue;
+        }
+        if (std::sscanf(line, "spawn %f %f", &parsed.spawn.x, &parsed.spawn.y) == 2) {
+            continue;
+        }
+        if (std::sscanf(line, "chunks %d %d %d %d", &parsed.minChunk.x, &parsed.minChunk.y, &parsed.maxChunk.x, &parsed.maxChunk.y) == 4) {
+            hasChunks = true;
+            continue;
+        }
+
+        SDL_Log("level %s: unknown line '%s'", directory.c_str(), line);
+        return false;
+    }
+
+    if (parsed.chunkSize <= 0 || !hasChunks) {
+        SDL_Log("level %s needs a positive chunk_size and a chunks range", directory.c_str());
+        return false;
+    }
+
+    info = parsed;
+    return true;
+}
+
+bool loadChunk(const LevelInfo &info, const ChunkCoord &coord, std::vector<PlatformSpawn> &platforms) {
+    platforms.clear();
+
+    const FilePtr file = openFile(chunkPath(info.directory, coord), "r");
+    if (!file) {
+        return true;
+    }
+
+    char line[128];
+    while (std::fgets(line, sizeof(line), file.get())) {
+        PlatformSpawn platform{};
+        if (std::sscanf(line, "step %d %d", &platform.x, &platform.y) == 2) {
+            platforms.push_back(platform);
+        } else if (line[0] != '#' && line[0] != '\n') {
+            SDL_Log("level %s: bad line in chunk %d,%d", info.directory.c_str(), coord.x, coord.y);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool writeLevel(const std::string &directory, const int &chunkSize, const SDL_FPoint &spawn, const std::vector<PlatformSpawn> &platforms) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    LevelInfo info;
+    info.directory = directory;
+    info.chunkSize = chunkSize;
+    info.minChunk = { INT_MAX, INT_MAX };
+    info.maxChunk = { INT_MIN, INT_MIN };
+
+    std::unordered_map<ChunkCoord, std::vector<PlatformSpawn>, ChunkCoordHash> chunks;
+    for (const auto &platform : platforms) {
+        const ChunkCoord coord = info.chunkAt(static_cast<float>(platform.x), static_cast<float>(platform.y));
+        chunks[coord].push_back(platform);
+
+        info.minChunk = { std::min(info.minChunk.x, coord.x), std::min(info.minChunk.y, coord.y) };
+        info.maxChunk = { std::max(info.maxChunk.x, coord.x), std::max(info.maxChunk.y, coord.y) };
+    }
+
+    if (chunks.empty()) {
+        info.minChunk = info.maxChunk = {};
+    }
+
+    for (const auto &[coord, chunkPlatforms] : chunks) {
+        const FilePtr file = openFile(chunkPath(directory, coord), "w");
+        if (!file) {
+            return false;
+        }
+        for (const auto &platform : chunkPlatforms) {
+            std::fprintf(file.get(), "step %d %d\n", platform.x, platform.y);
+        }
+    }
+
+    const FilePtr file = openFile(directory + "/level.txt", "w");
+    if (!file) {
+        return false;
+    }
+
+    std::fprintf(file.get(), "chunk_size %d\nspawn %g %g\nchunks %d %d %d %d\n", chunkSize, spawn.x, spawn.y,
+                 info.minChunk.x, info.minChunk.y, info.maxChunk.x, info.maxChunk.y);
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef BOUNCEPP_LEVEL_H
+#define BOUNCEPP_LEVEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+// a level is a directory holding level.txt and one chunk_<x>_<y>.txt per non-empty chunk.
+//
+// level.txt:
+//   chunk_size 1024         side of a square chunk in pixels
+//   spawn 500 400           player start
+//   chunks 0 0 1 0          min x, min y, max x, max y chunk coordinates, inclusive
+//
+// chunk files list one platform per line as "step <x> <y>", the top-left corner in world pixels.
+// a platform belongs to the chunk its top-left corner falls in. '#' starts a comment.
+
+struct ChunkCoord {
+    int x = 0;
+    int y = 0;
+
+    bool operator==(const ChunkCoord &other) const { return x == other.x && y == other.y; }
+};
+
+struct ChunkCoordHash {
+    size_t operator()(const ChunkCoord &coord) const {
+        return static_cast<size_t>(static_cast<uint32_t>(coord.x)) * 73856093u ^ static_cast<uint32_t>(coord.y) * 19349663u;
+    }
+};
+
+struct LevelInfo {
+    std::string directory;
+    int chunkSize = 1024;
+    SDL_FPoint spawn{ 500.0f, 400.0f };
+    ChunkCoord minChunk;
+    ChunkCoord maxChunk;
+
+    bool contains(const ChunkCoord &coord) const {
+        return coord.x >= minChunk.x && coord.x <= maxChunk.x && coord.y >= minChunk.y && coord.y <= maxChunk.y;
+    }
+
+    ChunkCoord chunkAt(const float &x, const float &y) const;
+};
+
+// top-left corner of a platform in world pixels
+using PlatformSpawn = SDL_Point;
+
+bool loadLevelInfo(const std::string &directory, LevelInfo &info);
+
+// a chunk inside the level bounds without a file is empty, that is not an error
+bool loadChunk(const LevelInfo &info, const ChunkCoord &coord, std::vector<PlatformSpawn> &platforms);
+
+// writes level.txt and the chunk files for the given platforms, the bounds are computed from them
+bool writeLevel(const std::string &directory, const int &chunkSize, const SDL_FPoint &spawn, const std::vector<PlatformSpawn> &platforms);
+
+#endif //BOUNCEPP_LEVEL_H
@@ -0,0 +1,159 @@
+#include "LevelStreamer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <span>
+
+LevelStreamer::LevelStreamer(Factory &factory, const LevelInfo &level, const int &loadRadius)
+    : _factory(factory), _level(level), _loadRadius(std::max(loadRadius, 0)), _unloadRadius(std::max(loadRadius, 0) + 1) {
+    _loader = std::thread(&LevelStreamer::loaderLoop, this);
+}
+
+LevelStreamer::~LevelStreamer() {
+    {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _wakeLoader.notify_one();
+    _loader.join();
+}
+
+void LevelStreamer::loaderLoop() {
+    std::vector<PlatformSpawn> platforms;
+
+    while (true) {
+        ChunkCoord coord;
+        {
+            std::unique_lock lock(_mutex);
+            _wakeLoader.wait(lock, [this] { return _stop || !_requests.empty(); });
+            if (_stop) {
+                return;
+            }
+            coord = _requests.front();
+            _requests.pop_front();
+        }
+
+        // file io and parsing happen outside the lock
+        if (!loadChunk(_level, coord, platforms)) {
+            platforms.clear();
+        }
+
+        std::lock_guard lock(_mutex);
+        _completed.push_back({ coord, platforms });
+    }
+}
+
+void LevelStreamer::request(const ChunkCoord &coord) {
+    if (!_level.contains(coord) || _chunks.contains(coord)) {
+        return;
+    }
+
+    _chunks.emplace(coord, Chunk());
+    {
+        std::lock_guard lock(_mutex);
+        _requests.push_back(coord);
+    }
+    _wakeLoader.notify_one();
+}
+
+void LevelStreamer::collectCompleted() {
+    std::vector<LoadedChunk> completed;
+    {
+        std::unique_lock lock(_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || _completed.empty()) {
+            return;
+        }
+        completed.swap(_completed);
+    }
+
+    for (auto &loaded : completed) {
+        // dropped while it was loading
+        const auto it = _chunks.find(loaded._coord);
+        if (it == _chunks.end() || it->second._loaded) {
+            continue;
+        }
+
+        it->second._loaded = true;
+        it->second._pending = std::move(loaded._platforms);
+        it->second._entities.reserve(it->second._pending.size());
+    }
+}
+
+void LevelStreamer::spawnPending(entt::registry &registry, int budget) {
+    for (auto &[coord, chunk] : _chunks) {
+        if (budget == 0) {
+            return;
+        }
+
+        // the tail of the pending list goes out as one batch
+        const size_t count = std::min(chunk._pending.size(), static_cast<size_t>(budget));
+        if (count == 0) {
+            continue;
+        }
+
+        const size_t first = chunk._pending.size() - count;
+        _factory.createSteps(registry, std::span<const PlatformSpawn>(chunk._pending).subspan(first), chunk._entities);
+        chunk._pending.resize(first);
+
+        _platformCount += count;
+        budget -= static_cast<int>(count);
+    }
+}
+
+void LevelStreamer::unloadChunk(entt::registry &registry, Chunk &chunk) {
+    for (const auto entity : chunk._entities) {
+        _factory.destroyEntity(registry, entity);
+    }
+
+    _platformCount -= chunk._entities.size();
+    chunk._entities.clear();
+}
+
+void LevelStreamer::update(entt::registry &registry, const SDL_FPoint &focus) {
+    const ChunkCoord center = _level.chunkAt(focus.x, focus.y);
+
+    // drop chunks that fell out of range, whether or not they finished loading
+    _toUnload.clear();
+    for (const auto &[coord, chunk] : _chunks) {
+        if (std::abs(coord.x - center.x) > _unloadRadius || std::abs(coord.y - center.y) > _unloadRadius) {
+            _toUnload.push_back(coord);
+        }
+    }
+    for (const auto &coord : _toUnload) {
+        unloadChunk(registry, _chunks[coord]);
+        _chunks.erase(coord);
+    }
+
+    for (int y = center.y - _loadRadius; y <= center.y + _loadRadius; y++) {
+        for (int x = center.x - _loadRadius; x <= center.x + _loadRadius; x++) {
+            request({ x, y });
+        }
+    }
+
+    collectCompleted();
+    spawnPending(registry, _spawnBudget);
+}
+
+void LevelStreamer::loadAround(entt::registry &registry, const SDL_FPoint &focus) {
+    update(registry, focus);
+
+    auto ready = [this] {
+        return std::all_of(_chunks.begin(), _chunks.end(), [](const auto &entry) {
+            return entry.second._loaded && entry.second._pending.empty();
+        });
+    };
+
+    while (!ready()) {
+        std::this_thread::yield();
+        collectCompleted();
+        spawnPending(registry, INT_MAX);
+    }
+}
+
+void LevelStreamer::unloadAll(entt::registry &registry) {
+    for (auto &[coord, chunk] : _chunks) {
+        unloadChunk(registry, chunk);
+    }
+    _chunks.clear();
+}
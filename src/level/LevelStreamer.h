@@ -0,0 +1,84 @@
+#ifndef BOUNCEPP_LEVELSTREAMER_H
+#define BOUNCEPP_LEVELSTREAMER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "Level.h"
+#include "../ecs/factories/factory.h"
+
+// keeps the platforms of the chunks around a focus point alive and nothing else.
+// chunk files are read and parsed on a loader thread, bodies are created and destroyed on the calling thread
+// through the factory, at most a fixed number of creations per update so a chunk arriving never causes a hitch.
+class LevelStreamer {
+
+private:
+    struct Chunk {
+        bool _loaded = false; // false while the loader thread still has it
+        std::vector<PlatformSpawn> _pending; // parsed but not created yet
+        std::vector<entt::entity> _entities;
+    };
+
+    struct LoadedChunk {
+        ChunkCoord _coord;
+        std::vector<PlatformSpawn> _platforms;
+    };
+
+    Factory &_factory;
+    LevelInfo _level;
+
+    int _loadRadius;   // chunks within this many chunks of the focus are kept
+    int _unloadRadius; // one more than the load radius so walking along a border does not thrash
+    int _spawnBudget = 2048;
+
+    // calling thread only
+    std::unordered_map<ChunkCoord, Chunk, ChunkCoordHash> _chunks;
+    std::vector<ChunkCoord> _toUnload;
+    size_t _platformCount = 0;
+
+    // shared with the loader thread
+    std::thread _loader;
+    std::mutex _mutex;
+    std::condition_variable _wakeLoader;
+    std::deque<ChunkCoord> _requests;
+    std::vector<LoadedChunk> _completed;
+    bool _stop = false;
+
+    void loaderLoop();
+
+    void request(const ChunkCoord &coord);
+    void collectCompleted();
+    void spawnPending(entt::registry &registry, int budget);
+    void unloadChunk(entt::registry &registry, Chunk &chunk);
+
+public:
+    LevelStreamer(Factory &factory, const LevelInfo &level, const int &loadRadius = 1);
+    ~LevelStreamer();
+
+    LevelStreamer(const LevelStreamer&) = delete;
+    LevelStreamer& operator=(const LevelStreamer&) = delete;
+
+    // call once per tick with the player's position, after the contact events are dispatched and before the step.
+    // unloading destroys platforms, see Factory::destroyEntity
+    void update(entt::registry &registry, const SDL_FPoint &focus);
+
+    // blocks until every chunk in range of focus exists, for startup and teleports
+    void loadAround(entt::registry &registry, const SDL_FPoint &focus);
+
+    // destroys every streamed platform, call before the registry or world go away
+    void unloadAll(entt::registry &registry);
+
+    void setSpawnBudget(const int &bodiesPerUpdate) { _spawnBudget = std::max(bodiesPerUpdate, 1); }
+
+    const LevelInfo& getLevel() const { return _level; }
+    size_t getChunkCount() const { return _chunks.size(); }
+    size_t getPlatformCount() const { return _platformCount; }
+};
+
+#endif //BOUNCEPP_LEVELSTREAMER_H
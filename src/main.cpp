@@ -1,69 +1,82 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <entt/entt.hpp>
 #include <box2d/box2d.h>
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_main.h>
 
-#define STB_IMAGE_IMPLEMENTATION
+#include "assets/AssetManager.h"
+#include "core/FrameScheduler.h"
+#include "core/Memory.h"
+#include "core/Profiler.h"
+#include "core/Paths.h"
+#include "core/TripleBuffer.h"
 #include "ecs/factories/factory.h"
+#include "ecs/systems/AiSystem.h"
+#include "ecs/systems/CameraSystem.h"
 #include "ecs/systems/GameLogic.h"
 #include "ecs/systems/InputSystem.h"
 #include "ecs/systems/physicsSystem.h"
-#include "vendor/stb/stb_image.h"
+#include "ecs/systems/RenderSnapshotSystem.h"
+#include "ecs/systems/RenderSystem.h"
+#include "level/LevelStreamer.h"
+#include "net/SpscQueue.h"
+#include "sim/InputLog.h"
+#include "sim/Scenario.h"
 
 constexpr int WINDOW_WIDTH = 800;
 constexpr int WINDOW_HEIGHT = 600;
+constexpr float GRAVITY = 10.98f;
 
-// load texture from file
-SDL_Texture* LoadTextureFromFile(SDL_Renderer *renderer, const char *filename)
-{
-    int w, h, channels;
-
-    // Force 4 channels (RGBA8). This is simplest and well-supported.
-    unsigned char *pixels = stbi_load(filename, &w, &h, &channels, STBI_rgb_alpha);
-    if (!pixels) {
-        SDL_Log("stb_image failed to load %s: %s", filename, stbi_failure_reason());
-        return NULL;
-    }
-
-    // Describe the pixel format to SDL.
-    // STBI_rgb_alpha gives us 4 bytes per pixel: R,G,B,A in 8 bits each.
-    const Uint32 pitch = (Uint32)(w * 4);  // bytes per row
-
-    SDL_Surface *surface = SDL_CreateSurfaceFrom(
-        w,
-        h,
-        SDL_PIXELFORMAT_RGBA32, // a.k.a. 32-bit RGBA8
-        pixels,
-        pitch
-    );
-
-    if (!surface) {
-        SDL_Log("SDL_CreateSurfaceFrom failed: %s", SDL_GetError());
-        stbi_image_free(pixels);
-        return NULL;
-    }
+// keyboard events from the render thread to the simulation thread
+using InputEventQueue = SpscQueue<SDL_Event, 256>;
 
-    // Upload to GPU as texture
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        SDL_Log("SDL_CreateTextureFromSurface failed: %s", SDL_GetError());
-        SDL_DestroySurface(surface);
-        stbi_image_free(pixels);
-        return NULL;
+// runtime tuning of the fixed tick rate (+/-) and box2d sub-steps ([/])
+void handleTuningKey(const SDL_Keycode key, PhysicsSystem &physicsSystem)
+{
+    switch (key) {
+        case SDLK_EQUALS:
+            physicsSystem.setTickRate(physicsSystem.getTickRate() + 10.0f);
+            break;
+        case SDLK_MINUS:
+            physicsSystem.setTickRate(physicsSystem.getTickRate() - 10.0f);
+            break;
+        case SDLK_RIGHTBRACKET:
+            physicsSystem.setSubStepCount(physicsSystem.getSubStepCount() + 1);
+            break;
+        case SDLK_LEFTBRACKET:
+            physicsSystem.setSubStepCount(physicsSystem.getSubStepCount() - 1);
+            break;
+        default:
+            return;
     }
 
-    // Cleanup CPU-side stuff:
-    SDL_DestroySurface(surface); // this does NOT free 'pixels' because we created the surface *from* external memory
-    stbi_image_free(pixels);     // so we still free it manually
-
-    return texture;
+    SDL_Log("physics: %.0f ticks/s, %d sub-steps", physicsSystem.getTickRate(), physicsSystem.getSubStepCount());
 }
 
 int main(int argc, char* argv[])
 {
+    // box2d allocates from the counted pool, before any world exists
+    installBox2dAllocator();
+
+    // --record FILE captures every tick's commands for replay with BouncePP_sim --replay FILE
+    // --profile FILE writes the last profiled frames on exit, .csv or a chrome trace
+    std::string recordPath;
+    std::string profilePath;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (std::strcmp(argv[i], "--record") == 0) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile") == 0) {
+            profilePath = argv[++i];
+        }
+    }
+
     if (!SDL_InitSubSystem(SDL_INIT_VIDEO))
     {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
@@ -90,114 +103,273 @@ int main(int argc, char* argv[])
     entt::registry registry;
 
     // systems
-    auto physicsSystem = new PhysicsSystem(10.98f);
+    auto physicsSystem = new PhysicsSystem(GRAVITY, TaskScheduler::getDefaultWorkerCount());
     auto inputSystem = new InputSystem();
+    auto aiSystem = new AiSystem(registry, physicsSystem->getTaskScheduler());
     auto gameLogicSystem = new GameLogic();
 
     // renderer
     SDL_Renderer* renderer = SDL_CreateRenderer(window, nullptr);
+    SDL_SetRenderVSync(renderer, 1);
+
+    // sprites are decoded in the background and packed into a shared atlas
+    auto assetManager = new AssetManager(renderer);
+    // sprite per entity type, as each archetype describes it
+    std::vector<SpriteHandle> sprites(ENTITY_TYPE_COUNT, NO_SPRITE);
+    forEachArchetype([&](auto archetype) {
+        using A = decltype(archetype);
+        if constexpr (A::TEXTURE != nullptr) {
+            sprites[A::TYPE] = assetManager->load(A::TEXTURE, A::TEXTURE_SIZE);
+        } else {
+            sprites[A::TYPE] = assetManager->createSolid(A::NAME, A::COLOR);
+        }
+    });
+    assetManager->waitAll();
 
-    // prepare block texture
-    const std::string ballImgPath = "/Users/shivankchopra/CLionProjects/Bounce++/resources/ball_image.png"; // todo Fixed relative paths
-    SDL_Texture* ballTexture = LoadTextureFromFile(renderer, ballImgPath.c_str());
-
-    // prepare platform texture
-    SDL_Texture* platformTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_UNKNOWN, SDL_TEXTUREACCESS_TARGET, PLATFORM_WIDTH, PLATFORM_HEIGHT);
-    SDL_Texture* prev = SDL_GetRenderTarget(renderer);
-    SDL_SetRenderTarget(renderer, platformTexture);
-    SDL_SetRenderDrawColor(renderer, 166, 44, 8, SDL_ALPHA_OPAQUE); // dark brown
-    SDL_RenderClear(renderer);
-    SDL_SetRenderTarget(renderer, prev);
-
-    // track textures
-    const std::vector<SDL_Texture*> textures = { ballTexture, platformTexture };
+    // batched sprite renderer, draws render snapshots on this thread while the simulation runs on its own
+    auto renderSystem = new RenderSystem(renderer, *assetManager);
+    auto renderSnapshotSystem = new RenderSnapshotSystem(registry, physicsSystem->getWorldId());
 
     // factory
-    auto factory = new Factory(textures, physicsSystem->getWorldId());
+    auto factory = new Factory(sprites, physicsSystem->getWorldId());
+
+    // a recording needs the world to be the same on replay, so it uses the built-in steps instead of streaming
+    const bool recording = !recordPath.empty();
 
     // create player ball
-    factory->createBall(registry, 500, 400);
+    ScenarioConfig scenarioConfig;
+    scenarioConfig.demoSteps = recording;
+    const entt::entity player = buildScenario(*factory, registry, scenarioConfig);
+
+    // camera follows the player through the level, owned by the render thread from here on
+    const entt::entity cameraEntity = factory->createCamera(registry, player);
+    const Camera camera = registry.get<Camera>(cameraEntity);
+
+    // platforms stream in around the player
+    LevelStreamer *levelStreamer = nullptr;
+    LevelInfo level;
+    if (!recording && loadLevelInfo(resourcePath("levels/demo"), level))
+    {
+        levelStreamer = new LevelStreamer(*factory, level);
+        levelStreamer->loadAround(registry, level.spawn);
+    }
 
-    // create platforms
-    constexpr int NUM_STEPS = 16;
+    InputLog inputLog(InputLogHeader{ scenarioConfig, GRAVITY, physicsSystem->getTickRate(), physicsSystem->getSubStepCount() });
+    uint32_t tick = 0;
+
+    // sim thread -> render thread, newest complete tick
+    TripleBuffer<RenderSnapshot> snapshots;
+    // render thread -> sim thread, the world area the camera showed last frame
+    TripleBuffer<SDL_FRect> views;
+    InputEventQueue inputEvents;
+    std::atomic<bool> simulating = true;
+
+    // first view and snapshot before the threads split, so the first frame has something to draw
+    int outputW = 0, outputH = 0;
+    SDL_GetCurrentRenderOutputSize(renderer, &outputW, &outputH);
+    camera._viewport = { static_cast<float>(outputW), static_cast<float>(outputH) };
+    views.back() = CameraSystem::getVisibleArea(camera);
+    views.publish();
+    views.acquire();
+    renderSnapshotSystem->capture(snapshots.back(), views.front(), tick, physicsSystem->getTimeStep());
+    snapshots.publish();
+
+    // simulation thread: owns the registry, box2d and every system except rendering until it is joined
+    std::thread simulationThread([&]
+    {
+        FrameScheduler frameScheduler;
+        const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+        Uint64 previousCounter = SDL_GetPerformanceCounter();
 
-    // upper steps
-    for (int i = 0; i < NUM_STEPS; i++) {
-        int y_offset = i * (30 + 10);
+        while (simulating.load(std::memory_order_acquire))
+        {
+            SDL_Event event;
+            while (inputEvents.pop(event))
+            {
+                inputSystem->queueSdlEvent(event);
 
-        if (i > floor(NUM_STEPS/2)) {
-            y_offset = (NUM_STEPS - i) * (30 + 10);
-        }
+                // a recording is only replayable at the rate it started with
+                if (event.type == SDL_EVENT_KEY_DOWN && !recording)
+                {
+                    handleTuningKey(event.key.key, *physicsSystem);
+                }
+            }
 
-        int x = 10 + i * (100 + 10);
-        int y = 500 - y_offset;
-        factory->createStep(registry, x, y);
-    }
+            const Uint64 counter = SDL_GetPerformanceCounter();
+            const double frameSeconds = static_cast<double>(counter - previousCounter) / counterFrequency;
+            previousCounter = counter;
 
-    // lower steps
-    for (int i = 0; i < NUM_STEPS; i++) {
-        int y_offset = i * (30 + 10);
+            // run as many fixed ticks as the elapsed time asks for, sleep until the next one is due otherwise
+            const double timeStep = physicsSystem->getTimeStep();
+            const int steps = frameScheduler.advance(frameSeconds, timeStep);
+            if (steps == 0)
+            {
+                const double untilNextTick = (1.0 - frameScheduler.getAlpha(timeStep)) * timeStep;
+                std::this_thread::sleep_for(std::chrono::duration<double>(untilNextTick));
+                continue;
+            }
 
-        if (i > floor(NUM_STEPS/2)) {
-            y_offset = (NUM_STEPS - i) * (30 + 10);
-        }
+            for (int i = 0; i < steps; i++)
+            {
+                inputSystem->processInput(registry); // determine commands
+                aiSystem->processAi(); // commands for AI balls
 
-        int x = 10 + i * (100 + 10);
-        int y = 500 + y_offset;
-        factory->createStep(registry, x, y);
-    }
+                if (recording)
+                {
+                    inputLog.capture(registry, tick);
+                }
+                tick++;
+
+                gameLogicSystem->applyInputActions(registry); // apply commands logic
+                gameLogicSystem->checkPhysicsEvents(physicsSystem->getWorldId(), registry);
+
+                // platforms only come and go between an event dispatch and the next step, see Factory::destroyEntity
+                if (levelStreamer && registry.valid(player))
+                {
+                    const SDL_FRect &rect = registry.get<RenderingData>(player)._rect;
+                    levelStreamer->update(registry, { rect.x + rect.w / 2.0f, rect.y + rect.h / 2.0f });
+                }
 
-    // Game loop
+                physicsSystem->updatePhysics(); // update physics world
+                physicsSystem->syncPhysicsWithRendering(registry); // sync rendering
+            }
+
+            // hand the newest state to the render thread, around wherever the camera looked last
+            views.acquire();
+            renderSnapshotSystem->capture(snapshots.back(), views.front(), tick, physicsSystem->getTimeStep());
+            snapshots.publish();
+        }
+    });
+
+    // render loop, this thread keeps the window and renderer as SDL requires
     SDL_Event event;
     bool running = true;
 
+    const Uint64 counterFrequency = SDL_GetPerformanceFrequency();
+    Uint64 previousCounter = SDL_GetPerformanceCounter();
+
     while (running)
     {
+        BOUNCEPP_PROFILE_BEGIN_FRAME();
+
         // process events
         while (SDL_PollEvent(&event))
         {
-            inputSystem->setSdlEvent(event);
+            if (event.type == SDL_EVENT_KEY_DOWN || event.type == SDL_EVENT_KEY_UP)
+            {
+                inputEvents.push(event); // a full queue drops the key, the sim is far behind anyway
+            }
 
             if (event.type == SDL_EVENT_QUIT)
             {
                 running = false;
             }
 
+            // cached static layer has to be redrawn when its target textures are lost
+            if (event.type == SDL_EVENT_RENDER_TARGETS_RESET ||
+                event.type == SDL_EVENT_RENDER_DEVICE_RESET)
+            {
+                renderSystem->invalidateStaticLayer();
+            }
+
             if (event.type == SDL_EVENT_KEY_DOWN)
             {
                 if (event.key.key == SDLK_ESCAPE)
                 {
                     running = false;
                 }
+
+#ifdef BOUNCEPP_PROFILE
+                // F3 shows the profiler overlay, F4 dumps the recent frames as a chrome trace
+                if (event.key.key == SDLK_F3)
+                {
+                    Profiler::instance().toggleOverlay();
+                }
+                if (event.key.key == SDLK_F4 && Profiler::instance().writeChromeTrace("bouncepp_trace.json"))
+                {
+                    SDL_Log("profile written to bouncepp_trace.json");
+                }
+#endif
             }
         }
 
-        inputSystem->processInput(registry); // determine commands
-        gameLogicSystem->applyInputActions(registry); // apply commands logic
+        const Uint64 counter = SDL_GetPerformanceCounter();
+        const double frameSeconds = static_cast<double>(counter - previousCounter) / counterFrequency;
+        previousCounter = counter;
+
+        // newest complete tick, the previous one stays on screen until the sim publishes another
+        snapshots.acquire();
+        const RenderSnapshot &snapshot = snapshots.front();
 
-        gameLogicSystem->checkPhysicsEvents(physicsSystem->getWorldId(), registry);
+        // blend from the snapshot's previous to its current tick over one step after it was published
+        const double sincePublished = static_cast<double>(SDL_GetTicksNS() - snapshot._publishedNs) / 1e9;
+        const float alpha = static_cast<float>(std::clamp(sincePublished / snapshot._timeStep, 0.0, 1.0));
 
-        physicsSystem->updatePhysics(); // update physics world
-        physicsSystem->syncPhysicsWithRendering(registry); // sync rendering
+        if (snapshot._hasCameraTarget)
+        {
+            const RenderInstance &target = snapshot._cameraTarget;
+            CameraSystem::follow(camera, {
+                target._prevPos.x + (target._rect.x - target._prevPos.x) * alpha + target._rect.w / 2.0f,
+                target._prevPos.y + (target._rect.y - target._prevPos.y) * alpha + target._rect.h / 2.0f
+            }, static_cast<float>(frameSeconds));
+        }
+
+        // sprites that finished decoding may belong to static entities already drawn without them
+        if (assetManager->update() > 0)
+        {
+            renderSystem->invalidateStaticLayer();
+        }
 
         // clear before rendering
         SDL_SetRenderDrawColor(renderer, 56, 180, 248, SDL_ALPHA_OPAQUE); // light blue
         SDL_RenderClear(renderer);
 
-        // render components
-        for (auto [entity, renderData, metaData] : registry.view<RenderingData, MetaData>().each()) {
-            if (metaData._entityType == EntityType::BALL) {
-                SDL_RenderTextureRotated(renderer, textures[EntityType::BALL], nullptr, &renderData._rect, renderData._rotDeg, nullptr, SDL_FLIP_NONE);
-            } else {
-                SDL_RenderTexture(renderer, textures[metaData._entityType], nullptr, &renderData._rect);
-            }
+        // render the snapshot, blended between its two physics states
+        {
+            BOUNCEPP_PROFILE_SCOPE("render");
+            renderSystem->render(snapshot, camera, alpha);
+        }
+
+#ifdef BOUNCEPP_PROFILE
+        Profiler::instance().drawOverlay(renderer);
+#endif
+
+        {
+            BOUNCEPP_PROFILE_SCOPE("present");
+            SDL_RenderPresent(renderer); // paced by vsync
         }
 
-        SDL_RenderPresent(renderer);
+        views.back() = CameraSystem::getVisibleArea(camera);
+        views.publish();
 
-        SDL_Delay(16); // A small delay (approx. 60 FPS)
+        BOUNCEPP_PROFILE_END_FRAME();
+    }
+
+    simulating.store(false, std::memory_order_release);
+    simulationThread.join();
+
+    if (!profilePath.empty())
+    {
+#ifdef BOUNCEPP_PROFILE
+        Profiler::instance().write(profilePath);
+#else
+        SDL_Log("--profile ignored, built without BOUNCEPP_PROFILE");
+#endif
+    }
+
+    if (recording)
+    {
+        inputLog.finish(tick, hashWorldState(registry));
+        if (inputLog.save(recordPath))
+        {
+            SDL_Log("recorded %zu commands over %u ticks to %s", inputLog.getRecordCount(), tick, recordPath.c_str());
+        }
     }
 
+    delete levelStreamer;
+    delete renderSnapshotSystem;
+    delete renderSystem;
+    delete assetManager;
     physicsSystem->destroyWorld();
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,20 @@
+#ifndef BOUNCEPP_NETCOMMAND_H
+#define BOUNCEPP_NETCOMMAND_H
+
+#include <cstdint>
+
+#include "SpscQueue.h"
+#include "../ecs/components/components.hpp"
+
+constexpr int MAX_NET_CLIENTS = 128;
+
+// a decoded input from a remote client, produced by the network receive thread
+struct NetCommand {
+    uint16_t _clientId;
+    components::Command _command;
+};
+
+// receive thread -> sim thread
+using NetCommandQueue = SpscQueue<NetCommand, 4096>;
+
+#endif //BOUNCEPP_NETCOMMAND_H
@@ -0,0 +1,299 @@
+#include "NetProtocol.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace components;
+
+// ByteWriter
+
+void ByteWriter::writeU8(const uint8_t value) {
+    if (_size + 1 > _capacity) {
+        _overflow = true;
+        return;
+    }
+    _data[_size++] = value;
+}
+
+void ByteWriter::writeU16(const uint16_t value) {
+    writeU8(static_cast<uint8_t>(value));
+    writeU8(static_cast<uint8_t>(value >> 8));
+}
+
+void ByteWriter::writeU32(const uint32_t value) {
+    writeU16(static_cast<uint16_t>(value));
+    writeU16(static_cast<uint16_t>(value >> 16));
+}
+
+void ByteWriter::writeVarint(uint32_t value) {
+    while (value >= 0x80) {
+        writeU8(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    writeU8(static_cast<uint8_t>(value));
+}
+
+void ByteWriter::writeZigZag(const int32_t value) {
+    writeVarint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+void ByteWriter::patchU16(const size_t &offset, const uint16_t value) {
+    if (offset + 2 > _size) {
+        return;
+    }
+    _data[offset] = static_cast<uint8_t>(value);
+    _data[offset + 1] = static_cast<uint8_t>(value >> 8);
+}
+
+// ByteReader
+
+uint8_t ByteReader::readU8() {
+    if (_offset + 1 > _size) {
+        _failed = true;
+        return 0;
+    }
+    return _data[_offset++];
+}
+
+uint16_t ByteReader::readU16() {
+    const uint16_t low = readU8();
+    return static_cast<uint16_t>(low | (readU8() << 8));
+}
+
+uint32_t ByteReader::readU32() {
+    const uint32_t low = readU16();
+    return low | (static_cast<uint32_t>(readU16()) << 16);
+}
+
+uint32_t ByteReader::readVarint() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        const uint8_t byte = readU8();
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    _failed = true;
+    return 0;
+}
+
+int32_t ByteReader::readZigZag() {
+    const uint32_t value = readVarint();
+    return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// input packets
+
+size_t writeInputPacket(const InputPacket &packet, uint8_t *buffer, const size_t &capacity) {
+    ByteWriter writer(buffer, capacity);
+    writer.writeU32(INPUT_MAGIC);
+    writer.writeU8(PROTOCOL_VERSION);
+    writer.writeU32(packet._sequence);
+    writer.writeU32(packet._ackedSnapshot);
+    writer.writeU8(static_cast<uint8_t>(packet._command));
+    return writer.overflowed() ? 0 : writer.size();
+}
+
+bool readInputPacket(const uint8_t *data, const size_t &size, InputPacket &packet) {
+    ByteReader reader(data, size);
+    if (reader.readU32() != INPUT_MAGIC || reader.readU8() != PROTOCOL_VERSION) {
+        return false;
+    }
+
+    packet._sequence = reader.readU32();
+    packet._ackedSnapshot = reader.readU32();
+
+    const uint8_t command = reader.readU8();
+    if (reader.failed() || command > Command::EMPTY_COMMAND) {
+        return false;
+    }
+    packet._command = static_cast<Command>(command);
+    return true;
+}
+
+// snapshots
+
+NetEntityState quantizeEntityState(const uint32_t entity, const RenderingData &renderingData, const b2Vec2 &velocity,
+                                   const bool awake, const EntityType entityType) {
+    NetEntityState state;
+    state._entity = entity;
+    state._x = static_cast<int32_t>(std::lround(renderingData._rect.x * 4.0f));
+    state._y = static_cast<int32_t>(std::lround(renderingData._rect.y * 4.0f));
+
+    double turns = renderingData._rotDeg / 360.0;
+    turns -= std::floor(turns);
+    state._rot = static_cast<uint16_t>(static_cast<uint32_t>(turns * 65536.0) & 0xFFFF);
+
+    state._velX = static_cast<int16_t>(std::clamp(std::lround(velocity.x * 100.0f), -32767L, 32767L));
+    state._velY = static_cast<int16_t>(std::clamp(std::lround(velocity.y * 100.0f), -32767L, 32767L));
+    state._flags = static_cast<uint8_t>((awake ? 1 : 0) | (static_cast<uint8_t>(entityType) << 1));
+    return state;
+}
+
+static void writeHeader(ByteWriter &writer, const SnapshotHeader &header, const uint16_t &fragment) {
+    writer.writeU32(SNAPSHOT_MAGIC);
+    writer.writeU8(PROTOCOL_VERSION);
+    writer.writeU32(header._snapshotId);
+    writer.writeU32(header._baselineId);
+    writer.writeU32(header._tick);
+    writer.writeU16(fragment);
+    writer.writeU16(0); // fragment count, patched at the end
+    writer.writeU16(0); // entry count, patched when the fragment is closed
+}
+
+static void writeEntry(ByteWriter &writer, const NetEntityState &state, const NetEntityState &base) {
+    uint8_t mask = 0;
+    if (state._x != base._x) mask |= FIELD_X;
+    if (state._y != base._y) mask |= FIELD_Y;
+    if (state._rot != base._rot) mask |= FIELD_ROT;
+    if (state._velX != base._velX || state._velY != base._velY) mask |= FIELD_VEL;
+    if (state._flags != base._flags) mask |= FIELD_FLAGS;
+
+    writer.writeVarint(state._entity);
+    writer.writeU8(mask);
+    if (mask & FIELD_X) writer.writeZigZag(state._x - base._x);
+    if (mask & FIELD_Y) writer.writeZigZag(state._y - base._y);
+    if (mask & FIELD_ROT) writer.writeZigZag(static_cast<int16_t>(state._rot - base._rot));
+    if (mask & FIELD_VEL) {
+        writer.writeZigZag(state._velX - base._velX);
+        writer.writeZigZag(state._velY - base._velY);
+    }
+    if (mask & FIELD_FLAGS) writer.writeU8(state._flags);
+}
+
+static bool sameState(const NetEntityState &a, const NetEntityState &b) {
+    return a._x == b._x && a._y == b._y && a._rot == b._rot && a._velX == b._velX && a._velY == b._velY && a._flags == b._flags;
+}
+
+void encodeSnapshot(const SnapshotHeader &header, const std::vector<NetEntityState> &current,
+                    const std::vector<NetEntityState> &baseline,
+                    std::vector<uint8_t> &packets, std::vector<size_t> &packetSizes) {
+    packets.clear();
+    packetSizes.clear();
+
+    size_t packetStart = 0;
+    uint16_t entries = 0;
+    uint16_t fragment = 0;
+
+    auto openPacket = [&] {
+        packetStart = packets.size();
+        packets.resize(packetStart + MAX_PACKET_SIZE);
+        entries = 0;
+    };
+
+    openPacket();
+    ByteWriter writer(packets.data() + packetStart, MAX_PACKET_SIZE);
+    writeHeader(writer, header, fragment);
+
+    auto closePacket = [&] {
+        writer.patchU16(ENTRY_COUNT_OFFSET, entries);
+        packetSizes.push_back(writer.size());
+        packets.resize(packetStart + writer.size());
+    };
+
+    auto reserveEntry = [&] {
+        if (writer.size() + MAX_ENTRY_SIZE <= MAX_PACKET_SIZE) {
+            return;
+        }
+        closePacket();
+        openPacket();
+        writer = ByteWriter(packets.data() + packetStart, MAX_PACKET_SIZE);
+        writeHeader(writer, header, ++fragment);
+    };
+
+    // merge walk over both sorted lists
+    const NetEntityState zero{};
+    size_t b = 0;
+    for (const auto &state : current) {
+        while (b < baseline.size() && baseline[b]._entity < state._entity) {
+            reserveEntry();
+            writer.writeVarint(baseline[b]._entity);
+            writer.writeU8(ENTRY_REMOVED);
+            entries++;
+            b++;
+        }
+
+        const bool inBaseline = b < baseline.size() && baseline[b]._entity == state._entity;
+        const NetEntityState &base = inBaseline ? baseline[b] : zero;
+        if (inBaseline) {
+            b++;
+            if (sameState(state, base)) {
+                continue; // unchanged, the client keeps its baseline copy
+            }
+        }
+
+        reserveEntry();
+        writeEntry(writer, state, base);
+        entries++;
+    }
+
+    for (; b < baseline.size(); b++) {
+        reserveEntry();
+        writer.writeVarint(baseline[b]._entity);
+        writer.writeU8(ENTRY_REMOVED);
+        entries++;
+    }
+
+    closePacket();
+
+    // every fragment learns how many fragments make up the snapshot
+    size_t offset = 0;
+    for (const size_t size : packetSizes) {
+        packets[offset + FRAGMENT_COUNT_OFFSET] = static_cast<uint8_t>(packetSizes.size());
+        packets[offset + FRAGMENT_COUNT_OFFSET + 1] = static_cast<uint8_t>(packetSizes.size() >> 8);
+        offset += size;
+    }
+}
+
+bool readSnapshotHeader(const uint8_t *data, const size_t &size, SnapshotHeader &header) {
+    ByteReader reader(data, size);
+    if (reader.readU32() != SNAPSHOT_MAGIC || reader.readU8() != PROTOCOL_VERSION) {
+        return false;
+    }
+
+    header._snapshotId = reader.readU32();
+    header._baselineId = reader.readU32();
+    header._tick = reader.readU32();
+    header._fragment = reader.readU16();
+    header._fragmentCount = reader.readU16();
+    header._entryCount = reader.readU16();
+    return !reader.failed() && header._fragment < header._fragmentCount;
+}
+
+bool applySnapshotFragment(const uint8_t *data, const size_t &size, const NetWorldState &baseline, NetWorldState &state) {
+    SnapshotHeader header;
+    if (!readSnapshotHeader(data, size, header)) {
+        return false;
+    }
+
+    ByteReader reader(data + SNAPSHOT_HEADER_SIZE, size - SNAPSHOT_HEADER_SIZE);
+    const NetEntityState zero{};
+
+    for (uint16_t i = 0; i < header._entryCount; i++) {
+        const uint32_t entity = reader.readVarint();
+        const uint8_t mask = reader.readU8();
+
+        if (mask & ENTRY_REMOVED) {
+            state.erase(entity);
+            continue;
+        }
+
+        const auto baseIt = baseline.find(entity);
+        NetEntityState next = baseIt != baseline.end() ? baseIt->second : zero;
+        next._entity = entity;
+
+        if (mask & FIELD_X) next._x += reader.readZigZag();
+        if (mask & FIELD_Y) next._y += reader.readZigZag();
+        if (mask & FIELD_ROT) next._rot = static_cast<uint16_t>(next._rot + reader.readZigZag());
+        if (mask & FIELD_VEL) {
+            next._velX = static_cast<int16_t>(next._velX + reader.readZigZag());
+            next._velY = static_cast<int16_t>(next._velY + reader.readZigZag());
+        }
+        if (mask & FIELD_FLAGS) next._flags = reader.readU8();
+
+        state[entity] = next;
+    }
+
+    return !reader.failed();
+}
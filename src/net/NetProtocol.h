@@ -0,0 +1,133 @@
+#ifndef BOUNCEPP_NETPROTOCOL_H
+#define BOUNCEPP_NETPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../ecs/components/components.hpp"
+
+// wire format shared by NetworkServer and NetworkClient. all integers are little endian,
+// snapshot entries use varints and zigzag-encoded deltas against the baseline snapshot.
+
+constexpr uint32_t INPUT_MAGIC = 0x4E495042;    // "BPIN"
+constexpr uint32_t SNAPSHOT_MAGIC = 0x4E535042; // "BPSN"
+constexpr uint8_t PROTOCOL_VERSION = 1;
+
+// stay under a typical path mtu so datagrams are never fragmented by ip
+constexpr size_t MAX_PACKET_SIZE = 1200;
+
+// upper bound of a single encoded snapshot entry
+constexpr size_t MAX_ENTRY_SIZE = 32;
+
+// snapshot id 0 means "no baseline", the packet carries full state
+constexpr uint32_t NO_BASELINE = 0;
+
+// entry change mask bits
+constexpr uint8_t FIELD_X = 1 << 0;
+constexpr uint8_t FIELD_Y = 1 << 1;
+constexpr uint8_t FIELD_ROT = 1 << 2;
+constexpr uint8_t FIELD_VEL = 1 << 3;
+constexpr uint8_t FIELD_FLAGS = 1 << 4;
+constexpr uint8_t ENTRY_REMOVED = 1 << 7;
+
+class ByteWriter {
+
+private:
+    uint8_t *_data;
+    size_t _capacity;
+    size_t _size = 0;
+    bool _overflow = false;
+
+public:
+    ByteWriter(uint8_t *data, const size_t &capacity) : _data(data), _capacity(capacity) {}
+
+    void writeU8(uint8_t value);
+    void writeU16(uint16_t value);
+    void writeU32(uint32_t value);
+    void writeVarint(uint32_t value);
+    void writeZigZag(int32_t value);
+
+    // overwrite an already written u16, used to patch counts once they are known
+    void patchU16(const size_t &offset, uint16_t value);
+
+    size_t size() const { return _size; }
+    bool overflowed() const { return _overflow; }
+};
+
+class ByteReader {
+
+private:
+    const uint8_t *_data;
+    size_t _size;
+    size_t _offset = 0;
+    bool _failed = false;
+
+public:
+    ByteReader(const uint8_t *data, const size_t &size) : _data(data), _size(size) {}
+
+    uint8_t readU8();
+    uint16_t readU16();
+    uint32_t readU32();
+    uint32_t readVarint();
+    int32_t readZigZag();
+
+    bool failed() const { return _failed; }
+    bool atEnd() const { return _offset >= _size; }
+};
+
+// client -> server, sent every client tick
+struct InputPacket {
+    uint32_t _sequence = 0;
+    uint32_t _ackedSnapshot = NO_BASELINE; // last snapshot the client fully received
+    components::Command _command = components::Command::EMPTY_COMMAND;
+};
+
+size_t writeInputPacket(const InputPacket &packet, uint8_t *buffer, const size_t &capacity);
+bool readInputPacket(const uint8_t *data, const size_t &size, InputPacket &packet);
+
+// quantized state of one dynamic entity as sent over the wire
+struct NetEntityState {
+    uint32_t _entity = 0;
+    int32_t _x = 0;     // quarter pixels, rect top-left
+    int32_t _y = 0;
+    uint16_t _rot = 0;  // 1/65536 of a turn
+    int16_t _velX = 0;  // centimeters per second
+    int16_t _velY = 0;
+    uint8_t _flags = 0; // bit 0 awake, bits 1-3 EntityType
+};
+
+NetEntityState quantizeEntityState(uint32_t entity, const components::RenderingData &renderingData, const b2Vec2 &velocity,
+                                   bool awake, components::EntityType entityType);
+
+// server -> client, one snapshot may span several fragments, each decodable on its own
+struct SnapshotHeader {
+    uint32_t _snapshotId = 0;
+    uint32_t _baselineId = NO_BASELINE;
+    uint32_t _tick = 0;
+    uint16_t _fragment = 0;
+    uint16_t _fragmentCount = 0;
+    uint16_t _entryCount = 0;
+};
+
+// size of the header as encoded, fragment count and entry count are patched at these offsets
+constexpr size_t SNAPSHOT_HEADER_SIZE = 4 + 1 + 4 + 4 + 4 + 2 + 2 + 2;
+constexpr size_t FRAGMENT_COUNT_OFFSET = 4 + 1 + 4 + 4 + 4 + 2;
+constexpr size_t ENTRY_COUNT_OFFSET = FRAGMENT_COUNT_OFFSET + 2;
+
+// delta-encodes `current` against `baseline` (both sorted by entity) into MAX_PACKET_SIZE packets.
+// packets are appended back to back to `packets`, `packetSizes` gets the size of each one.
+// both vectors are cleared first and keep their capacity between calls.
+void encodeSnapshot(const SnapshotHeader &header, const std::vector<NetEntityState> &current,
+                    const std::vector<NetEntityState> &baseline,
+                    std::vector<uint8_t> &packets, std::vector<size_t> &packetSizes);
+
+using NetWorldState = std::unordered_map<uint32_t, NetEntityState>;
+
+bool readSnapshotHeader(const uint8_t *data, const size_t &size, SnapshotHeader &header);
+
+// applies one fragment's entries to `state`, which must start out as a copy of the baseline
+bool applySnapshotFragment(const uint8_t *data, const size_t &size, const NetWorldState &baseline, NetWorldState &state);
+
+#endif //BOUNCEPP_NETPROTOCOL_H
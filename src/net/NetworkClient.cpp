@@ -0,0 +1,153 @@
+#include "NetworkClient.h"
+
+#include <algorithm>
+#include <chrono>
+
+using Clock = std::chrono::steady_clock;
+
+NetworkClient::NetworkClient(const int &sendIntervalMs, const uint32_t &seed)
+    : _sendIntervalMs(sendIntervalMs), _seed(seed == 0 ? 1 : seed) {
+}
+
+NetworkClient::~NetworkClient() {
+    disconnect();
+}
+
+bool NetworkClient::connect(const NetAddress &server) {
+    disconnect();
+
+    if (!_socket.open(0, server._ip == NetAddress::loopback(0)._ip)) {
+        return false;
+    }
+
+    _server = server;
+    _running.store(true, std::memory_order_release);
+    _thread = std::thread(&NetworkClient::run, this);
+    return true;
+}
+
+void NetworkClient::disconnect() {
+    _running.store(false, std::memory_order_release);
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    _socket.close();
+}
+
+void NetworkClient::sendInput() {
+    // xorshift, mostly idle with the odd jump or nudge
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+
+    InputPacket packet;
+    packet._sequence = ++_sequence;
+    packet._ackedSnapshot = _lastComplete;
+
+    switch (_seed % 16) {
+        case 0: packet._command = components::Command::JUMP; break;
+        case 1: packet._command = components::Command::MOVE_LEFT; break;
+        case 2: packet._command = components::Command::MOVE_RIGHT; break;
+        default: packet._command = components::Command::EMPTY_COMMAND; break;
+    }
+
+    uint8_t buffer[32];
+    if (const size_t size = writeInputPacket(packet, buffer, sizeof(buffer))) {
+        _socket.sendTo(_server, buffer, size);
+    }
+}
+
+void NetworkClient::receiveSnapshot(const uint8_t *data, const size_t &size) {
+    SnapshotHeader header;
+    if (!readSnapshotHeader(data, size, header) || header._snapshotId <= _lastComplete) {
+        return;
+    }
+
+    if (header._snapshotId != _pendingId) {
+        if (header._snapshotId < _pendingId) {
+            return; // late fragment of an older snapshot
+        }
+        if (_pendingId != NO_BASELINE) {
+            _snapshotsDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static const NetWorldState EMPTY_STATE;
+        _pendingBaseline = nullptr;
+        if (header._baselineId == NO_BASELINE) {
+            _pendingBaseline = &EMPTY_STATE;
+        } else {
+            const Baseline &baseline = _baselines[header._baselineId % BASELINE_HISTORY];
+            if (baseline._snapshotId == header._baselineId) {
+                _pendingBaseline = &baseline._state;
+            }
+        }
+
+        if (!_pendingBaseline) {
+            // the server deltas against something we no longer have, wait for it to catch up on our ack
+            _pendingId = NO_BASELINE;
+            _snapshotsDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        _pendingId = header._snapshotId;
+        _pendingState = *_pendingBaseline;
+        _pendingFragments.assign(header._fragmentCount, false);
+        _pendingMissing = header._fragmentCount;
+    }
+
+    if (header._fragment >= _pendingFragments.size() || _pendingFragments[header._fragment]) {
+        return;
+    }
+
+    if (!applySnapshotFragment(data, size, *_pendingBaseline, _pendingState)) {
+        return;
+    }
+    _pendingFragments[header._fragment] = true;
+
+    if (--_pendingMissing > 0) {
+        return;
+    }
+
+    Baseline &complete = _baselines[_pendingId % BASELINE_HISTORY];
+    complete._snapshotId = _pendingId;
+    complete._state.swap(_pendingState);
+    _lastComplete = _pendingId;
+    _pendingId = NO_BASELINE;
+
+    _entities.store(complete._state.size(), std::memory_order_relaxed);
+    _snapshotsCompleted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NetworkClient::run() {
+    uint8_t buffer[MAX_PACKET_SIZE];
+    auto nextSend = Clock::now();
+
+    while (_running.load(std::memory_order_acquire)) {
+        const auto now = Clock::now();
+        if (now >= nextSend) {
+            sendInput();
+            nextSend = now + std::chrono::milliseconds(_sendIntervalMs);
+        }
+
+        const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextSend - Clock::now()).count();
+        NetAddress from;
+        const int size = _socket.receiveFrom(from, buffer, sizeof(buffer), static_cast<int>(std::max<long long>(wait, 0)));
+        if (size <= 0 || !(from == _server)) {
+            continue;
+        }
+
+        _packetsReceived.fetch_add(1, std::memory_order_relaxed);
+        _bytesReceived.fetch_add(size, std::memory_order_relaxed);
+        receiveSnapshot(buffer, static_cast<size_t>(size));
+    }
+}
+
+NetworkClientStats NetworkClient::getStats() const {
+    NetworkClientStats stats;
+    stats.packetsReceived = _packetsReceived.load(std::memory_order_relaxed);
+    stats.bytesReceived = _bytesReceived.load(std::memory_order_relaxed);
+    stats.snapshotsCompleted = _snapshotsCompleted.load(std::memory_order_relaxed);
+    stats.snapshotsDropped = _snapshotsDropped.load(std::memory_order_relaxed);
+    stats.entities = _entities.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,75 @@
+#ifndef BOUNCEPP_NETWORKCLIENT_H
+#define BOUNCEPP_NETWORKCLIENT_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "NetProtocol.h"
+#include "UdpSocket.h"
+
+struct NetworkClientStats {
+    uint64_t packetsReceived = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t snapshotsCompleted = 0;
+    uint64_t snapshotsDropped = 0; // baseline unknown or fragments lost
+    size_t entities = 0;           // entities in the last complete snapshot
+};
+
+// minimal client used to exercise the server: sends pseudo-random commands at a fixed rate,
+// reassembles snapshots and acks the last complete one. runs on its own thread.
+class NetworkClient {
+
+private:
+    // complete snapshots kept as possible baselines, the server may delta against an older ack
+    static constexpr int BASELINE_HISTORY = 8;
+
+    struct Baseline {
+        uint32_t _snapshotId = NO_BASELINE;
+        NetWorldState _state;
+    };
+
+    UdpSocket _socket;
+    NetAddress _server;
+    std::thread _thread;
+    std::atomic<bool> _running{false};
+
+    int _sendIntervalMs;
+    uint32_t _seed;
+
+    // client thread only
+    uint32_t _sequence = 0;
+    std::array<Baseline, BASELINE_HISTORY> _baselines;
+    uint32_t _lastComplete = NO_BASELINE;
+    uint32_t _pendingId = NO_BASELINE;
+    const NetWorldState *_pendingBaseline = nullptr;
+    NetWorldState _pendingState;
+    std::vector<bool> _pendingFragments;
+    int _pendingMissing = 0;
+
+    std::atomic<uint64_t> _packetsReceived{0};
+    std::atomic<uint64_t> _bytesReceived{0};
+    std::atomic<uint64_t> _snapshotsCompleted{0};
+    std::atomic<uint64_t> _snapshotsDropped{0};
+    std::atomic<size_t> _entities{0};
+
+    void run();
+    void sendInput();
+    void receiveSnapshot(const uint8_t *data, const size_t &size);
+
+public:
+    explicit NetworkClient(const int &sendIntervalMs = 16, const uint32_t &seed = 1);
+    ~NetworkClient();
+
+    NetworkClient(const NetworkClient&) = delete;
+    NetworkClient& operator=(const NetworkClient&) = delete;
+
+    bool connect(const NetAddress &server);
+    void disconnect();
+
+    NetworkClientStats getStats() const;
+};
+
+#endif //BOUNCEPP_NETWORKCLIENT_H
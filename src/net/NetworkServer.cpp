@@ -0,0 +1,185 @@
+#include "NetworkServer.h"
+
+#include <algorithm>
+
+// how long the receive thread waits for a datagram before checking whether it should stop
+constexpr int RECEIVE_TIMEOUT_MS = 50;
+
+NetworkServer::~NetworkServer() {
+    stop();
+}
+
+bool NetworkServer::start(const uint16_t &port, const bool &loopbackOnly) {
+    stop();
+
+    if (!_socket.open(port, loopbackOnly)) {
+        return false;
+    }
+
+    for (auto &client : _clients) {
+        client._active.store(false, std::memory_order_relaxed);
+    }
+    _clientCount = 0;
+
+    _running.store(true, std::memory_order_release);
+    _receiveThread = std::thread(&NetworkServer::receiveLoop, this);
+    return true;
+}
+
+void NetworkServer::stop() {
+    _running.store(false, std::memory_order_release);
+    if (_receiveThread.joinable()) {
+        _receiveThread.join();
+    }
+    _socket.close();
+}
+
+void NetworkServer::setSnapshotInterval(const int &ticks) {
+    _snapshotInterval = std::max(ticks, 1);
+}
+
+int NetworkServer::findOrAddClient(const NetAddress &address) {
+    for (int i = 0; i < _clientCount; i++) {
+        if (_clients[i]._address == address) {
+            return i;
+        }
+    }
+
+    if (_clientCount == MAX_NET_CLIENTS) {
+        return -1;
+    }
+
+    // client ids follow join order, they map onto the NETWORK balls in creation order
+    ClientSlot &slot = _clients[_clientCount];
+    slot._address = address;
+    slot._lastSequence = 0;
+    slot._ackedSnapshot.store(NO_BASELINE, std::memory_order_relaxed);
+    slot._active.store(true, std::memory_order_release);
+    return _clientCount++;
+}
+
+void NetworkServer::receiveLoop() {
+    uint8_t buffer[MAX_PACKET_SIZE];
+
+    while (_running.load(std::memory_order_acquire)) {
+        NetAddress address;
+        const int size = _socket.receiveFrom(address, buffer, sizeof(buffer), RECEIVE_TIMEOUT_MS);
+        if (size <= 0) {
+            continue;
+        }
+
+        InputPacket packet;
+        if (!readInputPacket(buffer, static_cast<size_t>(size), packet)) {
+            continue;
+        }
+
+        const int clientId = findOrAddClient(address);
+        if (clientId < 0) {
+            continue;
+        }
+
+        // udp may reorder, anything older than what we already saw is stale
+        ClientSlot &slot = _clients[clientId];
+        if (packet._sequence <= slot._lastSequence) {
+            continue;
+        }
+        slot._lastSequence = packet._sequence;
+
+        if (packet._ackedSnapshot > slot._ackedSnapshot.load(std::memory_order_relaxed)) {
+            slot._ackedSnapshot.store(packet._ackedSnapshot, std::memory_order_relaxed);
+        }
+
+        if (packet._command == Command::EMPTY_COMMAND) {
+            continue;
+        }
+
+        _commandsReceived.fetch_add(1, std::memory_order_relaxed);
+        if (!_commands.push({ static_cast<uint16_t>(clientId), packet._command })) {
+            _commandsDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+const NetworkServer::HistoryEntry* NetworkServer::findBaseline(const uint32_t snapshotId) const {
+    if (snapshotId == NO_BASELINE) {
+        return nullptr;
+    }
+
+    const HistoryEntry &entry = _history[snapshotId % SNAPSHOT_HISTORY];
+    return entry._snapshotId == snapshotId ? &entry : nullptr;
+}
+
+void NetworkServer::sendSnapshot(const entt::registry &registry, const uint32_t &tick) {
+    if (!_socket.isOpen() || tick % _snapshotInterval != 0) {
+        return;
+    }
+
+    const uint32_t snapshotId = _nextSnapshotId++;
+    HistoryEntry &current = _history[snapshotId % SNAPSHOT_HISTORY];
+    current._snapshotId = snapshotId;
+    current._states.clear();
+
+    const auto view = registry.view<RenderingData, MetaData, PhysicsBody>(entt::exclude<StaticTag, Parked>);
+    for (auto [entity, renderingData, metaData, physicsBody] : view.each()) {
+        current._states.push_back(quantizeEntityState(
+            entt::to_integral(entity), renderingData,
+            b2Body_GetLinearVelocity(physicsBody._bodyId), b2Body_IsAwake(physicsBody._bodyId), metaData._entityType));
+    }
+
+    std::sort(current._states.begin(), current._states.end(), [](const NetEntityState &a, const NetEntityState &b) {
+        return a._entity < b._entity;
+    });
+
+    _stats.snapshots++;
+
+    // clients tend to ack the same snapshot, encode once per distinct baseline
+    static const std::vector<NetEntityState> EMPTY_BASELINE;
+    uint32_t encodedBaseline = UINT32_MAX;
+
+    for (auto &client : _clients) {
+        if (!client._active.load(std::memory_order_acquire)) {
+            break; // slots are filled in order
+        }
+
+        const HistoryEntry *baseline = findBaseline(client._ackedSnapshot.load(std::memory_order_relaxed));
+        const uint32_t baselineId = baseline ? baseline->_snapshotId : NO_BASELINE;
+
+        if (baselineId != encodedBaseline) {
+            SnapshotHeader header;
+            header._snapshotId = snapshotId;
+            header._baselineId = baselineId;
+            header._tick = tick;
+            encodeSnapshot(header, current._states, baseline ? baseline->_states : EMPTY_BASELINE, _packets, _packetSizes);
+            encodedBaseline = baselineId;
+        }
+
+        if (!baseline) {
+            _stats.fullSnapshots++;
+        }
+
+        size_t offset = 0;
+        for (const size_t size : _packetSizes) {
+            if (_socket.sendTo(client._address, _packets.data() + offset, size)) {
+                _stats.packetsSent++;
+                _stats.bytesSent += size;
+            } else {
+                _stats.sendFailures++;
+            }
+            offset += size;
+        }
+    }
+}
+
+NetworkServerStats NetworkServer::getStats() const {
+    NetworkServerStats stats = _stats;
+    stats.commandsReceived = _commandsReceived.load(std::memory_order_relaxed);
+    stats.commandsDropped = _commandsDropped.load(std::memory_order_relaxed);
+
+    for (const auto &client : _clients) {
+        if (!client._active.load(std::memory_order_acquire)) {
+            break;
+        }
+        stats.clients++;
+    }
+    return stats;
+}
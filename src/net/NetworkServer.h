@@ -0,0 +1,99 @@
+#ifndef BOUNCEPP_NETWORKSERVER_H
+#define BOUNCEPP_NETWORKSERVER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "NetCommand.h"
+#include "NetProtocol.h"
+#include "UdpSocket.h"
+
+using namespace components;
+
+struct NetworkServerStats {
+    int clients = 0;
+    uint64_t commandsReceived = 0;
+    uint64_t commandsDropped = 0; // queue was full, the sim thread fell behind
+    uint64_t snapshots = 0;
+    uint64_t fullSnapshots = 0;   // sent without a baseline, to new clients or after lost acks
+    uint64_t packetsSent = 0;
+    uint64_t bytesSent = 0;
+    uint64_t sendFailures = 0;    // socket buffer full, the packet was dropped rather than waited on
+};
+
+// authoritative side of the network path.
+// a receive thread decodes client inputs into a lock-free queue that InputSystem drains on the sim thread,
+// the sim thread sends delta-compressed snapshots of the dynamic bodies back. neither side ever blocks the other.
+class NetworkServer {
+
+private:
+    // snapshots kept around as baselines, a client ack older than this gets a full snapshot
+    static constexpr int SNAPSHOT_HISTORY = 32;
+
+    struct ClientSlot {
+        std::atomic<bool> _active{false};
+        std::atomic<uint32_t> _ackedSnapshot{NO_BASELINE};
+        NetAddress _address;        // written once by the receive thread before _active is set
+        uint32_t _lastSequence = 0; // receive thread only
+    };
+
+    struct HistoryEntry {
+        uint32_t _snapshotId = NO_BASELINE;
+        std::vector<NetEntityState> _states; // sorted by entity, capacity is kept between snapshots
+    };
+
+    UdpSocket _socket;
+    std::thread _receiveThread;
+    std::atomic<bool> _running{false};
+
+    NetCommandQueue _commands;
+    std::array<ClientSlot, MAX_NET_CLIENTS> _clients;
+    int _clientCount = 0; // receive thread only
+
+    std::atomic<uint64_t> _commandsReceived{0};
+    std::atomic<uint64_t> _commandsDropped{0};
+
+    // sim thread only
+    std::array<HistoryEntry, SNAPSHOT_HISTORY> _history;
+    uint32_t _nextSnapshotId = 1;
+    int _snapshotInterval = 3;
+    std::vector<uint8_t> _packets;
+    std::vector<size_t> _packetSizes;
+    NetworkServerStats _stats;
+
+    void receiveLoop();
+    int findOrAddClient(const NetAddress &address);
+
+    const HistoryEntry* findBaseline(uint32_t snapshotId) const;
+
+public:
+    NetworkServer() = default;
+    ~NetworkServer();
+
+    NetworkServer(const NetworkServer&) = delete;
+    NetworkServer& operator=(const NetworkServer&) = delete;
+
+    // binds the port and starts the receive thread
+    bool start(const uint16_t &port, const bool &loopbackOnly = false);
+    void stop();
+
+    uint16_t getPort() const { return _socket.getLocalPort(); }
+
+    // consumed by InputSystem on the sim thread
+    NetCommandQueue& getCommandQueue() { return _commands; }
+
+    // a snapshot goes out every `ticks` sim ticks
+    void setSnapshotInterval(const int &ticks);
+
+    // called on the sim thread after physics has been synced, only does work on snapshot ticks
+    void sendSnapshot(const entt::registry &registry, const uint32_t &tick);
+
+    NetworkServerStats getStats() const;
+};
+
+#endif //BOUNCEPP_NETWORKSERVER_H
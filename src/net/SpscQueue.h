@@ -0,0 +1,49 @@
+#ifndef BOUNCEPP_SPSCQUEUE_H
+#define BOUNCEPP_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// bounded lock-free queue for exactly one producer thread and one consumer thread.
+// neither side ever blocks: push fails when full, pop fails when empty.
+template<typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+private:
+    std::array<T, Capacity> _items{};
+
+    // head and tail live on their own cache lines so producer and consumer do not false-share
+    alignas(64) std::atomic<size_t> _head{0}; // next slot to pop, written by the consumer
+    alignas(64) std::atomic<size_t> _tail{0}; // next slot to push, written by the producer
+
+public:
+    bool push(const T &item) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+
+        _items[tail & (Capacity - 1)] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &item) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = _items[head & (Capacity - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t sizeApprox() const {
+        return _tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_relaxed);
+    }
+};
+
+#endif //BOUNCEPP_SPSCQUEUE_H
@@ -0,0 +1,126 @@
+#include "UdpSocket.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using socklen_t = int;
+#define poll WSAPoll
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <SDL3/SDL.h>
+
+UdpSocket::UdpSocket() : _handle() {
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+UdpSocket::~UdpSocket() {
+    close();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool UdpSocket::open(const uint16_t &port, const bool &loopbackOnly) {
+    close();
+
+    _handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    if (_handle == INVALID_SOCKET) {
+#else
+    if (_handle < 0) {
+#endif
+        SDL_Log("udp socket could not be created");
+        return false;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+
+    if (bind(_handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        SDL_Log("udp socket could not bind port %u", port);
+#ifdef _WIN32
+        closesocket(_handle);
+#else
+        ::close(_handle);
+#endif
+        return false;
+    }
+
+    // sends must never stall the sim thread, a full send buffer just drops the datagram
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(_handle, FIONBIO, &nonBlocking);
+#else
+    fcntl(_handle, F_SETFL, fcntl(_handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    _open = true;
+    return true;
+}
+
+void UdpSocket::close() {
+    if (!_open) {
+        return;
+    }
+
+#ifdef _WIN32
+    closesocket(_handle);
+#else
+    ::close(_handle);
+#endif
+    _open = false;
+}
+
+uint16_t UdpSocket::getLocalPort() const {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    if (getsockname(_handle, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+bool UdpSocket::sendTo(const NetAddress &address, const uint8_t *data, const size_t &size) const {
+    sockaddr_in target{};
+    target.sin_family = AF_INET;
+    target.sin_port = htons(address._port);
+    target.sin_addr.s_addr = htonl(address._ip);
+
+    const auto sent = sendto(_handle, reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+                             reinterpret_cast<const sockaddr*>(&target), sizeof(target));
+    return sent >= 0 && static_cast<size_t>(sent) == size;
+}
+
+int UdpSocket::receiveFrom(NetAddress &address, uint8_t *buffer, const size_t &capacity, const int &timeoutMs) const {
+    pollfd descriptor{};
+    descriptor.fd = _handle;
+    descriptor.events = POLLIN;
+
+    if (poll(&descriptor, 1, timeoutMs) <= 0) {
+        return -1;
+    }
+
+    sockaddr_in source{};
+    socklen_t length = sizeof(source);
+    const auto received = recvfrom(_handle, reinterpret_cast<char*>(buffer), static_cast<int>(capacity), 0,
+                                   reinterpret_cast<sockaddr*>(&source), &length);
+    if (received < 0) {
+        return -1;
+    }
+
+    address._ip = ntohl(source.sin_addr.s_addr);
+    address._port = ntohs(source.sin_port);
+    return static_cast<int>(received);
+}
@@ -0,0 +1,51 @@
+#ifndef BOUNCEPP_UDPSOCKET_H
+#define BOUNCEPP_UDPSOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+
+// ipv4 address and port, both in host byte order
+struct NetAddress {
+    uint32_t _ip = 0;
+    uint16_t _port = 0;
+
+    bool operator==(const NetAddress &other) const { return _ip == other._ip && _port == other._port; }
+
+    static NetAddress loopback(const uint16_t &port) { return { 0x7F000001u, port }; }
+};
+
+// non-blocking ipv4 udp socket
+class UdpSocket {
+
+private:
+#ifdef _WIN32
+    using Handle = uintptr_t;
+#else
+    using Handle = int;
+#endif
+
+    Handle _handle;
+    bool _open = false;
+
+public:
+    UdpSocket();
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // port 0 picks an ephemeral port, see getLocalPort
+    bool open(const uint16_t &port, const bool &loopbackOnly);
+    void close();
+
+    bool isOpen() const { return _open; }
+    uint16_t getLocalPort() const;
+
+    // never blocks, returns false if the datagram could not be queued right now
+    bool sendTo(const NetAddress &address, const uint8_t *data, const size_t &size) const;
+
+    // waits at most timeoutMs for a datagram, returns its size or -1 if none arrived
+    int receiveFrom(NetAddress &address, uint8_t *buffer, const size_t &capacity, const int &timeoutMs) const;
+};
+
+#endif //BOUNCEPP_UDPSOCKET_H
@@ -0,0 +1,182 @@
+#include "HeadlessSimulation.h"
+
+#include <chrono>
+
+#include "../core/Profiler.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(const Clock::time_point &start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+HeadlessSimulation::HeadlessSimulation(const ScenarioConfig &config, const int &workerCount, const float &gravity)
+    : _physicsSystem(gravity, workerCount, &_memory),
+      _aiSystem(_registry, _physicsSystem.getTaskScheduler()),
+      _factory({}, _physicsSystem.getWorldId()) {
+    const MemoryBudgetScope memoryScope(&_memory);
+    _player = buildScenario(_factory, _registry, config);
+}
+
+HeadlessSimulation::~HeadlessSimulation() {
+    _levelStreamer.reset();
+    _registry.clear();
+    _physicsSystem.destroyWorld();
+}
+
+void HeadlessSimulation::tick(SystemTimings &timings) {
+    // whichever thread runs the tick, what it allocates belongs to this world
+    const MemoryBudgetScope memoryScope(&_memory);
+
+    auto start = Clock::now();
+    if (_replay) {
+        BOUNCEPP_PROFILE_SCOPE("replay");
+        _replayCursor = _replay->apply(_registry, _tick, _replayCursor);
+        timings.input += secondsSince(start);
+    } else {
+        {
+            BOUNCEPP_PROFILE_SCOPE("processInput");
+            _inputSystem.processInput(_registry);
+        }
+        timings.input += secondsSince(start);
+
+        start = Clock::now();
+        {
+            BOUNCEPP_PROFILE_SCOPE("processAi");
+            _aiSystem.processAi();
+        }
+        timings.ai += secondsSince(start);
+    }
+
+    if (_recording) {
+        _recording->capture(_registry, _tick);
+    }
+
+    start = Clock::now();
+    {
+        BOUNCEPP_PROFILE_SCOPE("applyInputActions");
+        _gameLogic.applyInputActions(_registry);
+    }
+    timings.inputActions += secondsSince(start);
+
+    start = Clock::now();
+    {
+        BOUNCEPP_PROFILE_SCOPE("checkPhysicsEvents");
+        _gameLogic.checkPhysicsEvents(_physicsSystem.getWorldId(), _registry);
+    }
+    timings.physicsEvents += secondsSince(start);
+
+    // between the dispatch of the last step's events and the next step, so every contact of a destroyed
+    // platform has had its begin event counted
+    if (_levelStreamer && _registry.valid(_player)) {
+        BOUNCEPP_PROFILE_SCOPE("levelStreaming");
+        start = Clock::now();
+        const SDL_FRect &rect = _registry.get<RenderingData>(_player)._rect;
+        _levelStreamer->update(_registry, { rect.x + rect.w / 2.0f, rect.y + rect.h / 2.0f });
+        timings.levelStreaming += secondsSince(start);
+    }
+
+    start = Clock::now();
+    {
+        BOUNCEPP_PROFILE_SCOPE("updatePhysics");
+        _physicsSystem.updatePhysics();
+    }
+    timings.physicsStep += secondsSince(start);
+
+    start = Clock::now();
+    {
+        BOUNCEPP_PROFILE_SCOPE("syncPhysicsWithRendering");
+        _physicsSystem.syncPhysicsWithRendering(_registry);
+    }
+    timings.renderSync += secondsSince(start);
+
+    if (_networkServer) {
+        BOUNCEPP_PROFILE_SCOPE("sendSnapshot");
+        start = Clock::now();
+        _networkServer->sendSnapshot(_registry, _tick);
+        timings.network += secondsSince(start);
+    }
+
+    _tick++;
+}
+
+bool HeadlessSimulation::saveSnapshot(const std::string &path) const {
+    return saveWorldSnapshot(_registry, path);
+}
+
+int HeadlessSimulation::loadSnapshot(const std::string &path) {
+    const MemoryBudgetScope memoryScope(&_memory);
+    _levelStreamer.reset(); // its chunks die with the world
+    _registry.clear();
+    _physicsSystem.resetWorld();
+    _factory = Factory({}, _physicsSystem.getWorldId());
+
+    const int loaded = loadWorldSnapshot(_factory, _registry, path);
+
+    const auto players = _registry.view<ManualControlled>();
+    _player = players.begin() != players.end() ? *players.begin() : entt::null;
+    return loaded;
+}
+
+bool HeadlessSimulation::streamLevel(const std::string &directory) {
+    const MemoryBudgetScope memoryScope(&_memory);
+    LevelInfo level;
+    if (!loadLevelInfo(directory, level)) {
+        return false;
+    }
+
+    _levelStreamer = std::make_unique<LevelStreamer>(_factory, level);
+
+    SDL_FPoint focus = level.spawn;
+    if (_registry.valid(_player)) {
+        const SDL_FRect &rect = _registry.get<RenderingData>(_player)._rect;
+        focus = { rect.x + rect.w / 2.0f, rect.y + rect.h / 2.0f };
+    }
+    _levelStreamer->loadAround(_registry, focus);
+    return true;
+}
+
+void HeadlessSimulation::replayFrom(const InputLog *log) {
+    _replay = log;
+    _replayCursor = 0;
+}
+
+void HeadlessSimulation::attachNetworkServer(NetworkServer *server) {
+    _networkServer = server;
+    _inputSystem.setNetworkQueue(server ? &server->getCommandQueue() : nullptr);
+}
+
+uint64_t HeadlessSimulation::countAllocations() const {
+    return _allocationCounter ? _allocationCounter() : _memory.getAllocationCount();
+}
+
+SimulationStats HeadlessSimulation::run(const int ticks) {
+    SimulationStats stats;
+
+    uint64_t warmUpAllocations = 0;
+
+    const auto start = Clock::now();
+    for (int i = 0; i < ticks; i++) {
+        if (i == MEMORY_WARM_UP_TICKS) {
+            warmUpAllocations = countAllocations();
+        }
+
+        BOUNCEPP_PROFILE_BEGIN_FRAME(); // one profiler frame per tick
+        tick(stats.systems);
+        BOUNCEPP_PROFILE_END_FRAME();
+        stats.ticks++;
+
+        if (_memory.exceeded()) {
+            stats.memoryLimitExceeded = true;
+            break;
+        }
+    }
+    stats.seconds = secondsSince(start);
+
+    if (stats.ticks > MEMORY_WARM_UP_TICKS) {
+        stats.steadyStateAllocations = countAllocations() - warmUpAllocations;
+    }
+    stats.allAllocationsCounted = _allocationCounter != nullptr;
+
+    return stats;
+}
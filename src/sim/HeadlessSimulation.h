@@ -0,0 +1,125 @@
+#ifndef BOUNCEPP_HEADLESSSIMULATION_H
+#define BOUNCEPP_HEADLESSSIMULATION_H
+
+#include <memory>
+
+#include <entt/entt.hpp>
+
+#include "InputLog.h"
+#include "Scenario.h"
+#include "WorldSnapshot.h"
+#include "../core/Memory.h"
+#include "../ecs/factories/factory.h"
+#include "../ecs/systems/AiSystem.h"
+#include "../ecs/systems/GameLogic.h"
+#include "../ecs/systems/InputSystem.h"
+#include "../ecs/systems/physicsSystem.h"
+#include "../level/LevelStreamer.h"
+#include "../net/NetworkServer.h"
+
+// wall-clock time spent in each system over a run, in seconds
+struct SystemTimings {
+    double input = 0.0;
+    double ai = 0.0;
+    double inputActions = 0.0;
+    double physicsEvents = 0.0;
+    double physicsStep = 0.0;
+    double renderSync = 0.0;
+    double network = 0.0;
+    double levelStreaming = 0.0;
+};
+
+// ticks a run takes before its allocations count as steady state, pools and scratch blocks grow during them
+constexpr int MEMORY_WARM_UP_TICKS = 120;
+
+struct SimulationStats {
+    int ticks = 0;
+    double seconds = 0.0;
+    SystemTimings systems;
+
+    // allocations made after the first MEMORY_WARM_UP_TICKS ticks, by the counter given to countAllocationsWith.
+    // without one only this world's tracked memoryAllocate calls are seen, std containers are not
+    uint64_t steadyStateAllocations = 0;
+    bool allAllocationsCounted = false; // a counter was given, 0 then means the ticks allocated nothing
+    bool memoryLimitExceeded = false; // the run stopped early, see setMemoryLimit
+
+    double ticksPerSecond() const { return seconds > 0.0 ? ticks / seconds : 0.0; }
+};
+
+// runs the game systems against a registry without any window or renderer, as fast as the cpu allows
+class HeadlessSimulation {
+
+private:
+    // declared first so it outlives everything charged to it
+    MemoryBudget _memory;
+
+    entt::registry _registry;
+
+    PhysicsSystem _physicsSystem;
+    InputSystem _inputSystem;
+    AiSystem _aiSystem;
+    GameLogic _gameLogic;
+    Factory _factory;
+
+    entt::entity _player = entt::null;
+    std::unique_ptr<LevelStreamer> _levelStreamer;
+
+    NetworkServer *_networkServer = nullptr;
+
+    InputLog *_recording = nullptr;
+    const InputLog *_replay = nullptr;
+    size_t _replayCursor = 0;
+    uint32_t _tick = 0;
+
+    uint64_t (*_allocationCounter)() = nullptr;
+
+    uint64_t countAllocations() const;
+
+public:
+    explicit HeadlessSimulation(const ScenarioConfig &config, const int &workerCount = 1, const float &gravity = 10.98f);
+    ~HeadlessSimulation();
+
+    HeadlessSimulation(const HeadlessSimulation&) = delete;
+    HeadlessSimulation& operator=(const HeadlessSimulation&) = delete;
+
+    // stops early when the world goes over its memory limit
+    SimulationStats run(int ticks);
+
+    // advances the world by one fixed step and adds each system's time to timings.
+    // opens no profiler frame, so simulations on different threads can tick side by side
+    void tick(SystemTimings &timings);
+
+    // captures every tick's commands into the log, nullptr stops recording
+    void recordTo(InputLog *log) { _recording = log; }
+
+    // takes commands from the log instead of the input systems and AI, the world must match the log's header
+    void replayFrom(const InputLog *log);
+
+    uint32_t getTick() const { return _tick; }
+
+    bool saveSnapshot(const std::string &path) const;
+
+    // throws the current world away and restores the snapshot, returns the number of entities or -1
+    int loadSnapshot(const std::string &path);
+
+    // streams the level's platforms around the player ball, build the scenario with demoSteps off
+    bool streamLevel(const std::string &directory);
+
+    const LevelStreamer* getLevelStreamer() const { return _levelStreamer.get(); }
+
+    // feeds the server's commands to NETWORK balls and sends it a snapshot after every tick, nullptr detaches
+    void attachNetworkServer(NetworkServer *server);
+
+    // box2d, component pool and scratch memory of this world. 0 bytes is no limit
+    void setMemoryLimit(const uint64_t &bytes) { _memory.setLimit(bytes); }
+    const MemoryBudget& getMemory() const { return _memory; }
+
+    // process-wide allocation count used for SimulationStats::steadyStateAllocations, e.g. getAllocationCount
+    // from core/AllocationCounter.h. nullptr falls back to the world's tracked allocations
+    void countAllocationsWith(uint64_t (*counter)()) { _allocationCounter = counter; }
+
+    entt::registry& getRegistry() { return _registry; }
+    PhysicsSystem& getPhysicsSystem() { return _physicsSystem; }
+};
+
+#endif //BOUNCEPP_HEADLESSSIMULATION_H
@@ -0,0 +1,234 @@
+#include "InputLog.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <SDL3/SDL.h>
+
+constexpr uint32_t INPUT_LOG_MAGIC = 0x4C525042; // "BPRL"
+constexpr uint16_t INPUT_LOG_VERSION = 1;
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+// little endian helpers, records are varint encoded: tick delta, entity, command
+
+static void writeU32(std::vector<uint8_t> &out, const uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+static void writeU64(std::vector<uint8_t> &out, const uint64_t value) {
+    writeU32(out, static_cast<uint32_t>(value));
+    writeU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+static void writeFloat(std::vector<uint8_t> &out, const float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeU32(out, bits);
+}
+
+static void writeVarint(std::vector<uint8_t> &out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+struct LogReader {
+    const std::vector<uint8_t> &_data;
+    size_t _offset = 0;
+    bool _failed = false;
+
+    uint8_t readU8() {
+        if (_offset >= _data.size()) {
+            _failed = true;
+            return 0;
+        }
+        return _data[_offset++];
+    }
+
+    uint32_t readU32() {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) {
+            value |= static_cast<uint32_t>(readU8()) << (i * 8);
+        }
+        return value;
+    }
+
+    uint64_t readU64() {
+        const uint64_t low = readU32();
+        return low | (static_cast<uint64_t>(readU32()) << 32);
+    }
+
+    float readFloat() {
+        const uint32_t bits = readU32();
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint32_t readVarint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            const uint8_t byte = readU8();
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        _failed = true;
+        return 0;
+    }
+};
+
+void InputLog::capture(const entt::registry &registry, const uint32_t &tick) {
+    for (auto [entity, metaData] : registry.view<MetaData>().each()) {
+        if (metaData._currentCommand != Command::EMPTY_COMMAND) {
+            _records.push_back({ tick, entt::to_integral(entity), metaData._currentCommand });
+        }
+    }
+}
+
+void InputLog::finish(const uint32_t &ticks, const uint64_t &finalHash) {
+    _ticks = ticks;
+    _finalHash = finalHash;
+}
+
+size_t InputLog::apply(const entt::registry &registry, const uint32_t &tick, size_t cursor) const {
+    for (; cursor < _records.size() && _records[cursor].tick <= tick; cursor++) {
+        const InputRecord &record = _records[cursor];
+        if (record.tick < tick) {
+            continue;
+        }
+
+        const auto entity = static_cast<entt::entity>(record.entity);
+        if (!registry.valid(entity)) {
+            continue;
+        }
+
+        if (const auto *metaData = registry.try_get<MetaData>(entity)) {
+            metaData->_currentCommand = record.command;
+        }
+    }
+
+    return cursor;
+}
+
+bool InputLog::save(const std::string &path) const {
+    std::vector<uint8_t> data;
+    data.reserve(64 + _records.size() * 4);
+
+    writeU32(data, INPUT_LOG_MAGIC);
+    writeU32(data, INPUT_LOG_VERSION);
+    writeU32(data, static_cast<uint32_t>(_header.scenario.balls));
+    writeU32(data, static_cast<uint32_t>(_header.scenario.aiBalls));
+    writeU32(data, static_cast<uint32_t>(_header.scenario.networkBalls));
+    writeFloat(data, _header.gravity);
+    writeFloat(data, _header.tickRate);
+    writeU32(data, static_cast<uint32_t>(_header.subSteps));
+    writeU32(data, _ticks);
+    writeU64(data, _finalHash);
+    writeU32(data, static_cast<uint32_t>(_records.size()));
+
+    uint32_t previousTick = 0;
+    for (const auto &record : _records) {
+        writeVarint(data, record.tick - previousTick);
+        writeVarint(data, record.entity);
+        data.push_back(static_cast<uint8_t>(record.command));
+        previousTick = record.tick;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        SDL_Log("input log could not be written to %s", path.c_str());
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+bool InputLog::load(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        SDL_Log("input log %s could not be opened", path.c_str());
+        return false;
+    }
+
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    LogReader reader{ data };
+
+    if (reader.readU32() != INPUT_LOG_MAGIC || reader.readU32() != INPUT_LOG_VERSION) {
+        SDL_Log("%s is not a version %u input log", path.c_str(), INPUT_LOG_VERSION);
+        return false;
+    }
+
+    InputLogHeader header;
+    header.scenario.balls = static_cast<int>(reader.readU32());
+    header.scenario.aiBalls = static_cast<int>(reader.readU32());
+    header.scenario.networkBalls = static_cast<int>(reader.readU32());
+    header.gravity = reader.readFloat();
+    header.tickRate = reader.readFloat();
+    header.subSteps = static_cast<int>(reader.readU32());
+    const uint32_t ticks = reader.readU32();
+    const uint64_t finalHash = reader.readU64();
+    const uint32_t recordCount = reader.readU32();
+
+    std::vector<InputRecord> records;
+    records.reserve(recordCount);
+
+    uint32_t tick = 0;
+    for (uint32_t i = 0; i < recordCount && !reader._failed; i++) {
+        tick += reader.readVarint();
+        const uint32_t entity = reader.readVarint();
+        const uint8_t command = reader.readU8();
+        if (command >= Command::EMPTY_COMMAND) {
+            reader._failed = true;
+            break;
+        }
+        records.push_back({ tick, entity, static_cast<Command>(command) });
+    }
+
+    if (reader._failed) {
+        SDL_Log("input log %s is truncated or corrupt", path.c_str());
+        return false;
+    }
+
+    _header = header;
+    _records = std::move(records);
+    _ticks = ticks;
+    _finalHash = finalHash;
+    return true;
+}
+
+static uint64_t hashBytes(uint64_t hash, const void *data, const size_t size) {
+    const auto *bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t hashWorldState(const entt::registry &registry) {
+    uint64_t hash = FNV_OFFSET;
+
+    for (auto [entity, physicsBody] : registry.view<PhysicsBody>().each()) {
+        const uint32_t id = entt::to_integral(entity);
+        const b2Transform transform = b2Body_GetTransform(physicsBody._bodyId);
+        const b2Vec2 velocity = b2Body_GetLinearVelocity(physicsBody._bodyId);
+        const float angularVelocity = b2Body_GetAngularVelocity(physicsBody._bodyId);
+
+        hash = hashBytes(hash, &id, sizeof(id));
+        hash = hashBytes(hash, &transform.p, sizeof(transform.p));
+        hash = hashBytes(hash, &transform.q, sizeof(transform.q));
+        hash = hashBytes(hash, &velocity, sizeof(velocity));
+        hash = hashBytes(hash, &angularVelocity, sizeof(angularVelocity));
+    }
+
+    return hash;
+}
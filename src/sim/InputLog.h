@@ -0,0 +1,64 @@
+#ifndef BOUNCEPP_INPUTLOG_H
+#define BOUNCEPP_INPUTLOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "Scenario.h"
+#include "../ecs/components/components.hpp"
+
+using namespace components;
+
+// everything needed to rebuild the world a log was recorded against
+struct InputLogHeader {
+    ScenarioConfig scenario;
+    float gravity = 10.98f;
+    float tickRate = 60.0f;
+    int subSteps = 4;
+};
+
+struct InputRecord {
+    uint32_t tick;
+    uint32_t entity;
+    Command command;
+};
+
+// commands handed to GameLogic::applyInputActions, tick by tick.
+// replaying a log against the same starting world reproduces the run exactly, the final state hash proves it.
+class InputLog {
+
+private:
+    InputLogHeader _header;
+    std::vector<InputRecord> _records; // ordered by tick
+    uint32_t _ticks = 0;
+    uint64_t _finalHash = 0;
+
+public:
+    explicit InputLog(const InputLogHeader &header = {}) : _header(header) {}
+
+    // recording: call every tick after all input sources ran and before applyInputActions
+    void capture(const entt::registry &registry, const uint32_t &tick);
+
+    // recording: closes the log with the number of ticks run and hashWorldState at that point
+    void finish(const uint32_t &ticks, const uint64_t &finalHash);
+
+    // replay: writes the commands recorded for `tick` into MetaData, starting at `cursor`.
+    // returns the cursor for the next tick
+    size_t apply(const entt::registry &registry, const uint32_t &tick, size_t cursor) const;
+
+    bool save(const std::string &path) const;
+    bool load(const std::string &path);
+
+    const InputLogHeader& getHeader() const { return _header; }
+    size_t getRecordCount() const { return _records.size(); }
+    uint32_t getTicks() const { return _ticks; }
+    uint64_t getFinalHash() const { return _finalHash; }
+};
+
+// fnv-1a over every body's transform and velocity, bit exact
+uint64_t hashWorldState(const entt::registry &registry);
+
+#endif //BOUNCEPP_INPUTLOG_H
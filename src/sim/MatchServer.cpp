@@ -0,0 +1,178 @@
+#include "MatchServer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+#include "../core/Profiler.h"
+
+// weight of the newest tick in MatchStats::recentTickSeconds
+constexpr double RECENT_TICK_WEIGHT = 1.0 / 32.0;
+
+// Match
+
+Match::Match(const uint32_t &id, const MatchConfig &config, const double &startTime)
+    : _id(id),
+      _simulation(config.scenario, 1, config.gravity) { // matches run side by side, each steps its world inline
+    _simulation.getPhysicsSystem().setTickRate(config.tickRate);
+    _simulation.getPhysicsSystem().setSubStepCount(config.subSteps);
+    _simulation.setMemoryLimit(config.memoryLimit);
+
+    _timeStep = _simulation.getPhysicsSystem().getTimeStep();
+    _nextTickTime = startTime;
+}
+
+int Match::update(const double &now) {
+    _stats.memoryLimitExceeded = _simulation.getMemory().exceeded();
+
+    int steps = 0;
+    while (_nextTickTime <= now && steps < MAX_MATCH_CATCH_UP_TICKS && !_stats.memoryLimitExceeded) {
+        const auto start = std::chrono::steady_clock::now();
+        _simulation.tick(_stats.systems);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        _stats.ticks++;
+        _stats.tickSeconds += seconds;
+        _stats.lastTickSeconds = seconds;
+        _stats.maxTickSeconds = std::max(_stats.maxTickSeconds, seconds);
+        _stats.recentTickSeconds = _stats.ticks == 1 ? seconds : _stats.recentTickSeconds + (seconds - _stats.recentTickSeconds) * RECENT_TICK_WEIGHT;
+
+        _nextTickTime += _timeStep;
+        steps++;
+        _stats.memoryLimitExceeded = _simulation.getMemory().exceeded();
+    }
+
+    // still behind after catching up, skip the backlog so the match keeps real time instead of spiralling
+    if (_nextTickTime <= now) {
+        const auto behind = static_cast<uint64_t>((now - _nextTickTime) / _timeStep) + 1;
+        _stats.droppedTicks += behind;
+        _nextTickTime += static_cast<double>(behind) * _timeStep;
+    }
+
+    return steps;
+}
+
+double Match::getPendingCost(const double &now) const {
+    if (_nextTickTime > now) {
+        return 0.0;
+    }
+
+    const double dueSteps = std::min(std::floor((now - _nextTickTime) / _timeStep) + 1.0, static_cast<double>(MAX_MATCH_CATCH_UP_TICKS));
+    return dueSteps * _stats.recentTickSeconds;
+}
+
+// MatchServer
+
+MatchServer::MatchServer(const int &workerCount) : _taskScheduler(workerCount), _start(Clock::now()) {
+    _matches.reserve(MAX_MATCHES);
+    _due.reserve(MAX_MATCHES);
+}
+
+Match* MatchServer::createMatch(const MatchConfig &config) {
+    if (_matches.size() >= MAX_MATCHES) {
+        return nullptr;
+    }
+
+    _matches.push_back(std::make_unique<Match>(_nextMatchId++, config, now()));
+    return _matches.back().get();
+}
+
+bool MatchServer::destroyMatch(const uint32_t &id) {
+    const auto it = std::find_if(_matches.begin(), _matches.end(), [id](const auto &match) { return match->getId() == id; });
+    if (it == _matches.end()) {
+        return false;
+    }
+
+    _matches.erase(it);
+    return true;
+}
+
+Match* MatchServer::getMatch(const uint32_t &id) const {
+    for (const auto &match : _matches) {
+        if (match->getId() == id) {
+            return match.get();
+        }
+    }
+    return nullptr;
+}
+
+double MatchServer::now() const {
+    return std::chrono::duration<double>(Clock::now() - _start).count();
+}
+
+double MatchServer::getNextDueTime() const {
+    double next = INFINITY;
+    for (const auto &match : _matches) {
+        next = std::min(next, match->getNextTickTime());
+    }
+    return next;
+}
+
+int MatchServer::update() {
+    BOUNCEPP_PROFILE_SCOPE("updateMatches"); // matches ticked on the owning thread nest their scopes under this one
+
+    const double time = now();
+
+    _due.clear();
+    for (const auto &match : _matches) {
+        if (match->getNextTickTime() <= time) {
+            _due.push_back(match.get());
+        }
+    }
+    if (_due.empty()) {
+        return 0;
+    }
+
+    // most expensive first, so a slow match never starts last and holds the whole round up
+    std::sort(_due.begin(), _due.end(), [time](const Match *a, const Match *b) {
+        return a->getPendingCost(time) > b->getPendingCost(time);
+    });
+
+    // one claiming loop per worker, matches are handed out one at a time as workers free up
+    // instead of being dealt into fixed ranges up front
+    std::atomic<int> nextDue{0};
+    std::atomic<int> steps{0};
+    auto tickMatches = [&](int, int, uint32_t) {
+        int localSteps = 0;
+        for (int i = nextDue.fetch_add(1, std::memory_order_relaxed); i < static_cast<int>(_due.size());
+             i = nextDue.fetch_add(1, std::memory_order_relaxed)) {
+            localSteps += _due[i]->update(time);
+        }
+        steps.fetch_add(localSteps, std::memory_order_relaxed);
+    };
+
+    const int loops = std::min(static_cast<int>(_due.size()), _taskScheduler.getWorkerCount());
+    _taskScheduler.parallelFor(loops, 1, tickMatches);
+
+    return steps.load(std::memory_order_relaxed);
+}
+
+MatchServerStats MatchServer::run(const double &seconds) {
+    MatchServerStats stats;
+
+    const double start = now();
+    const double end = start + seconds;
+    while (now() < end) {
+        BOUNCEPP_PROFILE_BEGIN_FRAME(); // one profiler frame per round
+
+        const auto roundStart = Clock::now();
+        const int steps = update();
+        stats.busySeconds += std::chrono::duration<double>(Clock::now() - roundStart).count();
+
+        BOUNCEPP_PROFILE_END_FRAME();
+
+        if (steps > 0) {
+            stats.rounds++;
+            stats.ticks += static_cast<uint64_t>(steps);
+        }
+
+        const double wait = std::min(getNextDueTime(), end) - now();
+        if (wait > 0.0) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+        }
+    }
+    stats.seconds = now() - start;
+
+    return stats;
+}
@@ -0,0 +1,126 @@
+#ifndef BOUNCEPP_MATCHSERVER_H
+#define BOUNCEPP_MATCHSERVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "HeadlessSimulation.h"
+#include "Scenario.h"
+#include "../core/TaskScheduler.h"
+
+// box2d keeps a fixed table of worlds per process (B2_MAX_WORLDS) and every match owns one
+constexpr int MAX_MATCHES = 128;
+
+// a match further behind than this many steps drops the rest instead of spiralling
+constexpr int MAX_MATCH_CATCH_UP_TICKS = 4;
+
+struct MatchConfig {
+    ScenarioConfig scenario;
+    float tickRate = 60.0f;
+    int subSteps = 4;
+    float gravity = 10.98f;
+    uint64_t memoryLimit = 0; // bytes per match, 0 is no limit
+};
+
+// wall-clock time one match spent inside its own ticks, in seconds
+struct MatchStats {
+    uint64_t ticks = 0;
+    uint64_t droppedTicks = 0;
+    double tickSeconds = 0.0;
+    double lastTickSeconds = 0.0;
+    double maxTickSeconds = 0.0;
+    double recentTickSeconds = 0.0; // moving average over roughly the last 32 ticks, drives load balancing
+    bool memoryLimitExceeded = false; // the match stopped ticking, every due tick since is dropped
+    SystemTimings systems;
+
+    double meanTickSeconds() const { return ticks > 0 ? tickSeconds / static_cast<double>(ticks) : 0.0; }
+};
+
+// one independent game: its own registry, box2d world, game logic and AI, stepped at its own fixed rate.
+// a match is only ever ticked by one thread at a time, but not always the same one
+class Match {
+
+private:
+    uint32_t _id;
+    HeadlessSimulation _simulation;
+
+    double _timeStep;
+    double _nextTickTime; // on the server clock, see MatchServer::now
+
+    MatchStats _stats;
+
+public:
+    Match(const uint32_t &id, const MatchConfig &config, const double &startTime);
+
+    Match(const Match&) = delete;
+    Match& operator=(const Match&) = delete;
+
+    // runs every step that is due at now, at most MAX_MATCH_CATCH_UP_TICKS. returns the number of steps run
+    int update(const double &now);
+
+    // expected seconds the next update will take, the server starts the most expensive matches first
+    double getPendingCost(const double &now) const;
+
+    uint32_t getId() const { return _id; }
+    double getTimeStep() const { return _timeStep; }
+    double getNextTickTime() const { return _nextTickTime; }
+    const MatchStats& getStats() const { return _stats; }
+
+    HeadlessSimulation& getSimulation() { return _simulation; }
+};
+
+struct MatchServerStats {
+    int rounds = 0; // updates that ran at least one step
+    uint64_t ticks = 0;
+    double seconds = 0.0;
+    double busySeconds = 0.0; // wall time inside update, the rest was spent waiting for the next step
+
+    double ticksPerSecond() const { return seconds > 0.0 ? static_cast<double>(ticks) / seconds : 0.0; }
+};
+
+// hosts many independent matches in one process and ticks the due ones in parallel.
+// matches are created, destroyed and updated from the thread that owns the server
+class MatchServer {
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    TaskScheduler _taskScheduler;
+    Clock::time_point _start;
+
+    std::vector<std::unique_ptr<Match>> _matches;
+    uint32_t _nextMatchId = 1;
+
+    // matches with a step due this round, most expensive first. capacity is reused between rounds
+    std::vector<Match*> _due;
+
+    double getNextDueTime() const;
+
+public:
+    explicit MatchServer(const int &workerCount = TaskScheduler::getDefaultWorkerCount());
+
+    MatchServer(const MatchServer&) = delete;
+    MatchServer& operator=(const MatchServer&) = delete;
+
+    // the match's first step is due right away, returns nullptr once MAX_MATCHES are running
+    Match* createMatch(const MatchConfig &config);
+    bool destroyMatch(const uint32_t &id);
+
+    Match* getMatch(const uint32_t &id) const;
+    const std::vector<std::unique_ptr<Match>>& getMatches() const { return _matches; }
+
+    int getWorkerCount() const { return _taskScheduler.getWorkerCount(); }
+
+    // seconds since the server was created, every match is scheduled against this clock
+    double now() const;
+
+    // runs every step that is due across all matches, spread over the workers. returns the number of steps
+    int update();
+
+    // keeps updating for the given wall time, sleeping whenever no match has a step due
+    MatchServerStats run(const double &seconds);
+};
+
+#endif //BOUNCEPP_MATCHSERVER_H
@@ -0,0 +1,78 @@
+#include "Scenario.h"
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+static void createDemoSteps(Factory &factory, entt::registry &registry) {
+    constexpr int NUM_STEPS = 16;
+
+    std::vector<SDL_Point> steps;
+    steps.reserve(NUM_STEPS * 2);
+
+    // upper steps
+    for (int i = 0; i < NUM_STEPS; i++) {
+        int y_offset = i * (30 + 10);
+
+        if (i > floor(NUM_STEPS/2)) {
+            y_offset = (NUM_STEPS - i) * (30 + 10);
+        }
+
+        int x = 10 + i * (100 + 10);
+        int y = 500 - y_offset;
+        steps.push_back({ x, y });
+    }
+
+    // lower steps
+    for (int i = 0; i < NUM_STEPS; i++) {
+        int y_offset = i * (30 + 10);
+
+        if (i > floor(NUM_STEPS/2)) {
+            y_offset = (NUM_STEPS - i) * (30 + 10);
+        }
+
+        int x = 10 + i * (100 + 10);
+        int y = 500 + y_offset;
+        steps.push_back({ x, y });
+    }
+
+    std::vector<entt::entity> entities;
+    factory.createSteps(registry, steps, entities);
+}
+
+entt::entity buildScenario(Factory &factory, entt::registry &registry, const ScenarioConfig &config) {
+    entt::entity player = entt::null;
+    if (config.balls > 0) {
+        player = factory.createBall(registry, 500, 400);
+    }
+
+    // extra balls are laid out in a grid that grows upwards from above the steps
+    constexpr int BALLS_PER_ROW = 56;
+    constexpr int SPACING = BALL_WIDTH + 6;
+
+    const int manualBalls = std::max(config.balls - 1, 0);
+    const int stackedBalls = manualBalls + config.aiBalls + config.networkBalls;
+
+    std::vector<SDL_Point> positions;
+    positions.reserve(stackedBalls);
+    for (int i = 0; i < stackedBalls; i++) {
+        const int column = i % BALLS_PER_ROW;
+        const int row = i / BALLS_PER_ROW;
+        positions.push_back({ 20 + column * SPACING, 100 - row * SPACING });
+    }
+
+    // one batch per controller, in the same order the balls were laid out
+    const std::span<const SDL_Point> all(positions);
+    std::vector<entt::entity> balls;
+    balls.reserve(stackedBalls);
+    factory.createBalls(registry, all.subspan(0, manualBalls), balls, ControlledBy::MANUAL);
+    factory.createBalls(registry, all.subspan(manualBalls, config.aiBalls), balls, ControlledBy::AI);
+    factory.createBalls(registry, all.subspan(manualBalls + config.aiBalls), balls, ControlledBy::NETWORK);
+
+    if (config.demoSteps) {
+        createDemoSteps(factory, registry);
+    }
+
+    return player;
+}
@@ -0,0 +1,20 @@
+#ifndef BOUNCEPP_SCENARIO_H
+#define BOUNCEPP_SCENARIO_H
+
+#include <entt/entt.hpp>
+
+#include "../ecs/factories/factory.h"
+
+// describes the world a game or headless run starts from
+struct ScenarioConfig {
+    int balls = 1; // first ball spawns at the player start, the rest are stacked above the steps
+    int aiBalls = 0; // AI controlled, stacked after the manual ones
+    int networkBalls = 0; // one per remote client, stacked after the AI ones
+    bool demoSteps = true; // the built-in rows of steps, off when a level is streamed instead
+};
+
+// builds the demo level (two mirrored rows of steps) and the requested balls.
+// returns the player ball, or entt::null when there are no manual balls
+entt::entity buildScenario(Factory &factory, entt::registry &registry, const ScenarioConfig &config);
+
+#endif //BOUNCEPP_SCENARIO_H
@@ -0,0 +1,115 @@
+#include "WorldSnapshot.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "../core/MappedFile.h"
+
+bool saveWorldSnapshot(const entt::registry &registry, const std::string &path) {
+    const auto view = registry.view<PhysicsBody, RenderingData, MetaData>(entt::exclude<Parked>);
+
+    std::vector<SnapshotEntity> records;
+    records.reserve(view.size_hint());
+
+    for (auto [entity, physicsBody, renderingData, metaData] : view.each()) {
+        const b2BodyId bodyId = physicsBody._bodyId;
+        const b2Transform transform = b2Body_GetTransform(bodyId);
+
+        SnapshotEntity record{};
+        record.entity = entt::to_integral(entity);
+        record.entityType = static_cast<uint8_t>(metaData._entityType);
+        record.controlledBy = static_cast<uint8_t>(metaData._controlledBy);
+        record.flags = b2Body_IsAwake(bodyId) ? SNAPSHOT_AWAKE : 0;
+
+        record.rect = renderingData._rect;
+        record.rotDeg = renderingData._rotDeg;
+        if (const auto *groundContact = registry.try_get<GroundContact>(entity)) {
+            record.lastImpactSpeed = groundContact->_lastImpactSpeed;
+        }
+
+        record.position = transform.p;
+        record.rotation = transform.q;
+        record.linearVelocity = b2Body_GetLinearVelocity(bodyId);
+        record.angularVelocity = b2Body_GetAngularVelocity(bodyId);
+        records.push_back(record);
+    }
+
+    WorldSnapshotHeader header{};
+    header.magic = WORLD_SNAPSHOT_MAGIC;
+    header.version = WORLD_SNAPSHOT_VERSION;
+    header.recordSize = sizeof(SnapshotEntity);
+    header.entityCount = static_cast<uint32_t>(records.size());
+
+    std::unique_ptr<FILE, int(*)(FILE*)> file(std::fopen(path.c_str(), "wb"), std::fclose);
+    if (!file) {
+        SDL_Log("world snapshot could not be written to %s", path.c_str());
+        return false;
+    }
+
+    // two writes, the records go out as one block
+    return std::fwrite(&header, sizeof(header), 1, file.get()) == 1 &&
+           (records.empty() || std::fwrite(records.data(), sizeof(SnapshotEntity), records.size(), file.get()) == records.size());
+}
+
+int loadWorldSnapshot(Factory &factory, entt::registry &registry, const std::string &path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        SDL_Log("world snapshot %s could not be opened", path.c_str());
+        return -1;
+    }
+
+    WorldSnapshotHeader header;
+    if (file.size() < sizeof(header)) {
+        SDL_Log("world snapshot %s is truncated", path.c_str());
+        return -1;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (header.magic != WORLD_SNAPSHOT_MAGIC || header.version != WORLD_SNAPSHOT_VERSION || header.recordSize != sizeof(SnapshotEntity)) {
+        SDL_Log("%s is not a version %u world snapshot", path.c_str(), WORLD_SNAPSHOT_VERSION);
+        return -1;
+    }
+
+    if (file.size() < sizeof(header) + static_cast<size_t>(header.entityCount) * sizeof(SnapshotEntity)) {
+        SDL_Log("world snapshot %s is truncated", path.c_str());
+        return -1;
+    }
+
+    // mmap is page aligned and the header keeps the records aligned, so they are read straight from the mapping
+    const auto *records = reinterpret_cast<const SnapshotEntity*>(file.data() + sizeof(header));
+    const size_t count = header.entityCount;
+
+    // one allocation per pool instead of growing them entity by entity
+    registry.storage<entt::entity>().reserve(count);
+    registry.storage<PhysicsBody>().reserve(count);
+    registry.storage<RenderingData>().reserve(count);
+    registry.storage<MetaData>().reserve(count);
+
+    int loaded = 0;
+    for (size_t i = 0; i < count; i++) {
+        const SnapshotEntity &record = records[i];
+        if (record.entityType >= ENTITY_TYPE_COUNT || record.controlledBy > ControlledBy::NOT_CONTROLLED) {
+            continue;
+        }
+
+        const BodyState bodyState{
+            record.position, record.rotation, record.linearVelocity, record.angularVelocity, (record.flags & SNAPSHOT_AWAKE) != 0
+        };
+
+        const entt::entity entity = factory.restoreEntity(registry, static_cast<entt::entity>(record.entity),
+                                                          static_cast<EntityType>(record.entityType),
+                                                          static_cast<ControlledBy>(record.controlledBy),
+                                                          record.rect, record.rotDeg, bodyState);
+
+        if (const auto *groundContact = registry.try_get<GroundContact>(entity)) {
+            groundContact->_lastImpactSpeed = record.lastImpactSpeed;
+        }
+        loaded++;
+    }
+
+    return loaded;
+}
@@ -0,0 +1,62 @@
+#ifndef BOUNCEPP_WORLDSNAPSHOT_H
+#define BOUNCEPP_WORLDSNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include <entt/entt.hpp>
+
+#include "../ecs/factories/factory.h"
+
+using namespace components;
+
+// on-disk layout of a world snapshot: one header followed by a flat array of fixed-size entity records.
+// fields are in native byte order and the records are 8-byte aligned, so a mapped file is read in place.
+
+constexpr uint32_t WORLD_SNAPSHOT_MAGIC = 0x534E5042; // "BPNS"
+constexpr uint32_t WORLD_SNAPSHOT_VERSION = 1;
+
+struct WorldSnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;  // sizeof(SnapshotEntity) when written, guards against layout changes
+    uint32_t entityCount;
+    uint64_t reserved[2];
+};
+
+// record flags
+constexpr uint8_t SNAPSHOT_AWAKE = 1 << 0;
+
+struct SnapshotEntity {
+    uint32_t entity;
+    uint8_t entityType;
+    uint8_t controlledBy;
+    uint8_t flags;
+    uint8_t reserved;
+
+    // components
+    SDL_FRect rect;
+    double rotDeg;
+    float lastImpactSpeed;
+
+    // box2d body
+    b2Vec2 position;
+    b2Rot rotation;
+    b2Vec2 linearVelocity;
+    float angularVelocity;
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotEntity>, "snapshot records are copied as raw bytes");
+static_assert(sizeof(SnapshotEntity) == 64, "one record per cache line");
+static_assert(sizeof(WorldSnapshotHeader) % alignof(SnapshotEntity) == 0, "records must stay aligned after the header");
+
+// writes every entity that has a body. contact pairs are not saved, box2d finds them again on the first step
+// after loading and its begin-touch events rebuild GroundContact
+bool saveWorldSnapshot(const entt::registry &registry, const std::string &path);
+
+// maps the file and recreates its entities through the factory, keeping entity ids where they are free.
+// the registry and the factory's world are expected to be empty. returns the number of entities loaded or -1
+int loadWorldSnapshot(Factory &factory, entt::registry &registry, const std::string &path);
+
+#endif //BOUNCEPP_WORLDSNAPSHOT_H
@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/AllocationCounter.h"
+#include "core/Memory.h"
+#include "core/Profiler.h"
+#include "level/Level.h"
+#include "net/NetworkClient.h"
+#include "sim/HeadlessSimulation.h"
+#include "sim/MatchServer.h"
+
+static void printUsage(const char *program) {
+    std::printf("usage: %s [--ticks N] [--balls N] [--ai-balls N] [--tick-rate HZ] [--substeps N] [--workers N]"
+                " [--net-clients N] [--net-port PORT]"
+                " [--record FILE] [--replay FILE]"
+                " [--load-world FILE] [--save-world FILE]"
+                " [--level DIR] [--generate-level DIR [--platforms N]]"
+                " [--matches N]"
+                " [--memory-limit MIB]"
+                " [--profile FILE]\n", program);
+}
+
+static double millisecondsSince(const std::chrono::steady_clock::time_point &start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// tiles the demo's zigzag steps over a square area, one row of steps every 400 pixels
+static bool generateLevel(const std::string &directory, const int platforms) {
+    const int columns = std::max(static_cast<int>(std::sqrt(platforms * 4.0)), 1);
+
+    std::vector<PlatformSpawn> spawns;
+    spawns.reserve(platforms);
+    for (int i = 0; i < platforms; i++) {
+        const int column = i % columns;
+        const int row = i / columns;
+        const int zigzag = column % 16 > 8 ? 16 - column % 16 : column % 16;
+        spawns.push_back({ 10 + column * (PLATFORM_WIDTH / 2 + 10), 500 + row * 400 - zigzag * 40 });
+    }
+
+    return writeLevel(directory, 1024, { 500.0f, 400.0f }, spawns);
+}
+
+static void printSystemTime(const char *name, const double seconds, const int ticks) {
+    std::printf("  %-26s %10.3f ms total %10.3f us/tick\n", name, seconds * 1000.0, seconds * 1e6 / ticks);
+}
+
+// live and peak bytes per subsystem, and how often each allocated
+static void printMemory(const char *title, const MemoryBudget &budget) {
+    std::printf("%s: %.1f KiB live", title, budget.getBytes() / 1024.0);
+    if (budget.getLimit() > 0) {
+        std::printf(" of %.1f KiB allowed", budget.getLimit() / 1024.0);
+    }
+    std::printf("\n");
+
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++) {
+        const auto subsystem = static_cast<MemorySubsystem>(i);
+        const MemoryUsage usage = budget.getUsage(subsystem);
+        std::printf("  %-26s %10.1f KiB live %10.1f KiB peak %10llu allocations %10llu frees\n", memorySubsystemName(subsystem),
+                    usage.bytes / 1024.0, usage.peakBytes / 1024.0,
+                    static_cast<unsigned long long>(usage.allocations), static_cast<unsigned long long>(usage.frees));
+    }
+}
+
+// frames are ticks, or server rounds with --matches
+static bool writeProfile(const std::string &path, const char *frameName) {
+#ifdef BOUNCEPP_PROFILE
+    if (!Profiler::instance().write(path)) {
+        return false;
+    }
+    std::printf("profile of the last %d %s written to %s\n",
+                static_cast<int>(std::min<uint64_t>(Profiler::instance().getFrameCount(), PROFILER_FRAME_HISTORY)), frameName, path.c_str());
+#else
+    std::printf("--profile ignored, built without BOUNCEPP_PROFILE\n");
+#endif
+    return true;
+}
+
+// hosts the scenario as many independent matches for ticks / tickRate seconds of wall time
+static int runMatches(const int matches, const MatchConfig &matchConfig, const int ticks, const int workers,
+                      const std::string &profilePath) {
+    MatchServer server(workers);
+    for (int i = 0; i < matches; i++) {
+        server.createMatch(matchConfig);
+    }
+
+    const double seconds = ticks / matchConfig.tickRate;
+    const MatchServerStats stats = server.run(seconds);
+
+    std::printf("matches: %zu, balls: %d, ai balls: %d each, %.0f Hz, %d sub-steps, %d workers\n", server.getMatches().size(),
+                matchConfig.scenario.balls, matchConfig.scenario.aiBalls, matchConfig.tickRate, matchConfig.subSteps, server.getWorkerCount());
+    std::printf("elapsed: %.3f s, %d rounds, %llu match ticks, %.1f ticks/s, workers busy %.1f%% of the time\n", stats.seconds, stats.rounds,
+                static_cast<unsigned long long>(stats.ticks), stats.ticksPerSecond(),
+                stats.seconds > 0.0 ? stats.busySeconds * 100.0 / stats.seconds : 0.0);
+
+    uint64_t dropped = 0;
+    int overLimit = 0;
+    double slowestMean = 0.0;
+    double slowestTick = 0.0;
+    double meanSum = 0.0;
+    for (const auto &match : server.getMatches()) {
+        const MatchStats &matchStats = match->getStats();
+        dropped += matchStats.droppedTicks;
+        overLimit += matchStats.memoryLimitExceeded ? 1 : 0;
+        slowestMean = std::max(slowestMean, matchStats.meanTickSeconds());
+        slowestTick = std::max(slowestTick, matchStats.maxTickSeconds);
+        meanSum += matchStats.meanTickSeconds();
+    }
+
+    const double matchCount = static_cast<double>(std::max<size_t>(server.getMatches().size(), 1));
+    std::printf("per match tick: %.3f us mean, %.3f us slowest mean, %.3f us worst, %llu ticks dropped\n",
+                meanSum * 1e6 / matchCount, slowestMean * 1e6, slowestTick * 1e6, static_cast<unsigned long long>(dropped));
+
+    if (overLimit > 0) {
+        std::printf("%d matches stopped over the memory limit\n", overLimit);
+    }
+
+    printMemory("process memory", MemoryBudget::process());
+    std::printf("  %-26s %10.1f KiB\n", "reserved by the pool", getMemoryReservedBytes() / 1024.0);
+
+    if (!profilePath.empty() && !writeProfile(profilePath, "rounds")) {
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    // before any world exists, box2d cannot switch allocators while one is alive
+    installBox2dAllocator();
+
+    int ticks = 600;
+    float tickRate = 60.0f;
+    int subSteps = 4;
+    int workers = TaskScheduler::getDefaultWorkerCount();
+    int netPort = 27015;
+    std::string recordPath;
+    std::string replayPath;
+    std::string loadWorldPath;
+    std::string saveWorldPath;
+    std::string levelPath;
+    std::string generateLevelPath;
+    std::string profilePath;
+    int platforms = 1000000;
+    int matches = 0;
+    uint64_t memoryLimit = 0;
+    ScenarioConfig config;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--balls") == 0 && i + 1 < argc) {
+            config.balls = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ai-balls") == 0 && i + 1 < argc) {
+            config.aiBalls = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tickRate = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--substeps") == 0 && i + 1 < argc) {
+            subSteps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--net-clients") == 0 && i + 1 < argc) {
+            config.networkBalls = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--net-port") == 0 && i + 1 < argc) {
+            netPort = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--load-world") == 0 && i + 1 < argc) {
+            loadWorldPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--save-world") == 0 && i + 1 < argc) {
+            saveWorldPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            levelPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--generate-level") == 0 && i + 1 < argc) {
+            generateLevelPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--platforms") == 0 && i + 1 < argc) {
+            platforms = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            matches = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--memory-limit") == 0 && i + 1 < argc) {
+            memoryLimit = static_cast<uint64_t>(std::max(std::atof(argv[++i]), 0.0) * 1024.0 * 1024.0);
+        } else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!generateLevelPath.empty()) {
+        const auto generateStart = std::chrono::steady_clock::now();
+        if (platforms <= 0 || !generateLevel(generateLevelPath, platforms)) {
+            return 1;
+        }
+        std::printf("wrote %d platforms to %s in %.0f ms\n", platforms, generateLevelPath.c_str(), millisecondsSince(generateStart));
+        return 0;
+    }
+
+    // every match builds the scenario on its own, nothing else applies to them
+    if (matches > 0) {
+        if (matches > MAX_MATCHES || ticks <= 0 || config.networkBalls > 0 || !recordPath.empty() || !replayPath.empty() ||
+            !loadWorldPath.empty() || !saveWorldPath.empty() || !levelPath.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        MatchConfig matchConfig;
+        matchConfig.scenario = config;
+        matchConfig.tickRate = tickRate;
+        matchConfig.subSteps = subSteps;
+        matchConfig.memoryLimit = memoryLimit;
+        return runMatches(matches, matchConfig, ticks, workers, profilePath);
+    }
+
+    // a replay rebuilds the recorded world and runs exactly the recorded number of ticks
+    InputLog replay;
+    float gravity = InputLogHeader().gravity;
+    if (!replayPath.empty()) {
+        if (!replay.load(replayPath)) {
+            return 1;
+        }
+        config = replay.getHeader().scenario;
+        gravity = replay.getHeader().gravity;
+        tickRate = replay.getHeader().tickRate;
+        subSteps = replay.getHeader().subSteps;
+        ticks = static_cast<int>(replay.getTicks());
+    }
+
+    // input logs describe the world by its scenario, a loaded or streamed world has none
+    const bool loggingInput = !recordPath.empty() || !replayPath.empty();
+    if (ticks <= 0 || config.networkBalls < 0 || config.networkBalls > MAX_NET_CLIENTS ||
+        (loggingInput && (!loadWorldPath.empty() || !levelPath.empty()))) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    config.demoSteps = levelPath.empty();
+
+    HeadlessSimulation simulation(config, workers, gravity);
+    simulation.getPhysicsSystem().setTickRate(tickRate);
+    simulation.getPhysicsSystem().setSubStepCount(subSteps);
+    simulation.setMemoryLimit(memoryLimit);
+    simulation.countAllocationsWith(getAllocationCount); // every operator new of the process, not just the pools
+
+    if (!loadWorldPath.empty()) {
+        const auto loadStart = std::chrono::steady_clock::now();
+        const int loaded = simulation.loadSnapshot(loadWorldPath);
+        if (loaded < 0) {
+            return 1;
+        }
+        std::printf("loaded %d entities from %s in %.2f ms\n", loaded, loadWorldPath.c_str(), millisecondsSince(loadStart));
+    }
+
+    if (!levelPath.empty()) {
+        if (!simulation.streamLevel(levelPath)) {
+            return 1;
+        }
+        std::printf("streaming %s: %zu chunks, %zu platforms around the player\n", levelPath.c_str(),
+                    simulation.getLevelStreamer()->getChunkCount(), simulation.getLevelStreamer()->getPlatformCount());
+    }
+
+    InputLog recording(InputLogHeader{ config, gravity, simulation.getPhysicsSystem().getTickRate(),
+                                       simulation.getPhysicsSystem().getSubStepCount() });
+    if (!recordPath.empty()) {
+        simulation.recordTo(&recording);
+    }
+    if (!replayPath.empty()) {
+        simulation.replayFrom(&replay);
+    }
+
+    // loopback clients, one per NETWORK ball. a replay takes their commands from the log instead
+    const bool networked = config.networkBalls > 0 && replayPath.empty();
+    NetworkServer server;
+    std::vector<std::unique_ptr<NetworkClient>> clients;
+    if (networked) {
+        if (!server.start(static_cast<uint16_t>(netPort), true)) {
+            return 1;
+        }
+        simulation.attachNetworkServer(&server);
+
+        for (int i = 0; i < config.networkBalls; i++) {
+            clients.push_back(std::make_unique<NetworkClient>(16, static_cast<uint32_t>(i + 1)));
+            clients.back()->connect(NetAddress::loopback(server.getPort()));
+        }
+    }
+
+    const SimulationStats stats = simulation.run(ticks);
+    const uint64_t finalHash = hashWorldState(simulation.getRegistry());
+
+    std::printf("ticks: %d, balls: %d, ai balls: %d, %.0f Hz, %d sub-steps, %d workers\n", stats.ticks, config.balls, config.aiBalls,
+                simulation.getPhysicsSystem().getTickRate(), simulation.getPhysicsSystem().getSubStepCount(),
+                simulation.getPhysicsSystem().getWorkerCount());
+    std::printf("elapsed: %.3f s, %.1f ticks/s\n", stats.seconds, stats.ticksPerSecond());
+    printSystemTime("processInput", stats.systems.input, stats.ticks);
+    printSystemTime("processAi", stats.systems.ai, stats.ticks);
+    printSystemTime("applyInputActions", stats.systems.inputActions, stats.ticks);
+    printSystemTime("checkPhysicsEvents", stats.systems.physicsEvents, stats.ticks);
+    printSystemTime("updatePhysics", stats.systems.physicsStep, stats.ticks);
+    printSystemTime("syncPhysicsWithRendering", stats.systems.renderSync, stats.ticks);
+    if (!levelPath.empty()) {
+        printSystemTime("levelStreaming", stats.systems.levelStreaming, stats.ticks);
+    }
+
+    printMemory("world memory", simulation.getMemory());
+    if (stats.ticks > MEMORY_WARM_UP_TICKS) {
+        std::printf("  %llu %s after the first %d ticks\n", static_cast<unsigned long long>(stats.steadyStateAllocations),
+                    stats.allAllocationsCounted ? "heap allocations in the process" : "tracked allocations of the world", MEMORY_WARM_UP_TICKS);
+    }
+    if (stats.memoryLimitExceeded) {
+        std::printf("  stopped after %d of %d ticks, over the memory limit\n", stats.ticks, ticks);
+    }
+
+    if (networked) {
+        printSystemTime("sendSnapshot", stats.systems.network, stats.ticks);
+
+        for (auto &client : clients) {
+            client->disconnect();
+        }
+        simulation.attachNetworkServer(nullptr);
+        server.stop();
+
+        const NetworkServerStats serverStats = server.getStats();
+        std::printf("server: %d clients, %llu commands (%llu dropped), %llu snapshots (%llu full), %llu packets, %.1f KiB sent, %llu send failures\n",
+                    serverStats.clients,
+                    static_cast<unsigned long long>(serverStats.commandsReceived), static_cast<unsigned long long>(serverStats.commandsDropped),
+                    static_cast<unsigned long long>(serverStats.snapshots), static_cast<unsigned long long>(serverStats.fullSnapshots),
+                    static_cast<unsigned long long>(serverStats.packetsSent), serverStats.bytesSent / 1024.0,
+                    static_cast<unsigned long long>(serverStats.sendFailures));
+
+        NetworkClientStats total;
+        for (const auto &client : clients) {
+            const NetworkClientStats clientStats = client->getStats();
+            total.packetsReceived += clientStats.packetsReceived;
+            total.bytesReceived += clientStats.bytesReceived;
+            total.snapshotsCompleted += clientStats.snapshotsCompleted;
+            total.snapshotsDropped += clientStats.snapshotsDropped;
+            total.entities = std::max(total.entities, clientStats.entities);
+        }
+        std::printf("clients: %llu packets, %.1f KiB received, %llu snapshots complete, %llu dropped, %zu entities tracked\n",
+                    static_cast<unsigned long long>(total.packetsReceived), total.bytesReceived / 1024.0,
+                    static_cast<unsigned long long>(total.snapshotsCompleted),
+                    static_cast<unsigned long long>(total.snapshotsDropped), total.entities);
+    }
+
+    std::printf("world hash: %016llx\n", static_cast<unsigned long long>(finalHash));
+
+    // the last PROFILER_FRAME_HISTORY ticks, one profiler frame each
+    if (!profilePath.empty() && !writeProfile(profilePath, "ticks")) {
+        return 1;
+    }
+
+    if (!saveWorldPath.empty()) {
+        const auto saveStart = std::chrono::steady_clock::now();
+        if (!simulation.saveSnapshot(saveWorldPath)) {
+            return 1;
+        }
+        std::printf("saved world to %s in %.2f ms\n", saveWorldPath.c_str(), millisecondsSince(saveStart));
+    }
+
+    if (!recordPath.empty()) {
+        recording.finish(simulation.getTick(), finalHash);
+        if (!recording.save(recordPath)) {
+            return 1;
+        }
+        std::printf("recorded %zu commands over %u ticks to %s\n", recording.getRecordCount(), recording.getTicks(), recordPath.c_str());
+    }
+
+    if (!replayPath.empty()) {
+        const bool match = finalHash == replay.getFinalHash();
+        std::printf("replay of %zu commands: %s (recorded %016llx)\n", replay.getRecordCount(), match ? "identical" : "DIVERGED",
+                    static_cast<unsigned long long>(replay.getFinalHash()));
+        if (!match) {
+            return 2;
+        }
+    }
+
+    return 0;
+}